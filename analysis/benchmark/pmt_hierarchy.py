@@ -0,0 +1,75 @@
+import argparse
+import os
+import re
+import subprocess
+
+import numpy as np
+import pandas as pd
+
+# compares the nested PMT model with the flattened one (/geometry/PMT/flatten): step rate and photocathode acceptance.
+# run from the build directory, e.g. python3 ../analysis/benchmark/pmt_hierarchy.py --events 100000
+
+macro_template = """
+/control/execute macros/init_physics.mac
+/control/execute macros/init_primary_photon.mac
+/control/execute macros/init_geom.mac
+/geometry/PMT/flatten {flatten}
+
+/run/initialize
+
+/control/execute macros/init_data.mac
+/daq/output_file   {output}
+/daq/output_mode   tracks
+/daq/glass_filter  true
+/daq/photons_filter true
+
+/run/beamOn {events}
+"""
+
+
+def run(executable, flatten, events, directory):
+    name   = "flattened" if flatten else "nested"
+    macro  = os.path.join(directory, f"benchmark_pmt_{name}.mac")
+    output = os.path.join(directory, f"benchmark_pmt_{name}.csv")
+
+    with open(macro, "w") as f:
+        f.write(macro_template.format(flatten=str(flatten).lower(), output=output, events=events))
+
+    log = subprocess.run([executable, "--batch", macro, "--physics", "optical"], capture_output=True, text=True, check=True).stdout
+
+    # ">> N steps, X steps per second" from OMRunAction
+    match = re.search(r">> (\d+) steps, ([\d.e+]+) steps per second", log)
+    steps, rate = int(match.group(1)), float(match.group(2))
+
+    df = pd.read_csv(output)
+    detected = df[(df["out_VolumeName"].str.contains("photocathode")) & (df["out_ProcessName"] == "OpAbsorption")]
+    per_pmt  = detected.groupby("out_Volume_CopyNo").size()
+
+    return name, steps, rate, len(detected), per_pmt
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--executable", default="./optical_module")
+    parser.add_argument("--events",     default=100000, type=int, help="primary photons per model")
+    parser.add_argument("--directory",  default=".",    help="where macros and output files are written")
+    args = parser.parse_args()
+
+    results = [run(args.executable, flatten, args.events, args.directory) for flatten in (False, True)]
+
+    print(f"{'model':10s}{'steps':>12s}{'steps/s':>12s}{'µs/step':>10s}{'detected':>10s}{'acceptance':>20s}")
+    for name, steps, rate, detected, _ in results:
+        acceptance = detected / args.events
+        error      = np.sqrt(acceptance * (1 - acceptance) / args.events)
+        print(f"{name:10s}{steps:12d}{rate:12.0f}{1e6 / rate:10.3f}{detected:10d}{acceptance:12.5f} ± {error:.5f}")
+
+    # the models describe the same geometry, the acceptances have to agree within the statistical error
+    (_, _, rate_n, detected_n, per_pmt_n), (_, _, rate_f, detected_f, per_pmt_f) = results
+    significance = (detected_f - detected_n) / np.sqrt(max(detected_f + detected_n, 1))
+    print(f"\nspeedup of the flattened model: {rate_f / rate_n:.3f}")
+    print(f"difference of detected photons: {detected_f - detected_n} ({significance:.2f} sigma)")
+
+    per_pmt = pd.DataFrame({"nested": per_pmt_n, "flattened": per_pmt_f}).fillna(0).astype(int)
+    print("\ndetected photons per PMT:")
+    print(per_pmt.to_string())
@@ -0,0 +1,176 @@
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+# reproducible performance benchmarks: fixed seeds, no geometry or physics table caches, no progress reports.
+# every scenario writes the startup profile and run summary of OMProfiler, the results are collected in one JSON
+# file and optionally compared against a stored baseline. Run from the build directory or via 'make benchmark':
+# python3 ../analysis/benchmark/run_benchmarks.py --baseline ../analysis/benchmark/baseline.json
+
+macro_template = """
+/control/execute macros/init_physics.mac
+/physics/tableCache
+/control/execute {primary}
+{geometry}
+/geometry/gdml/cache
+
+/random/setSeeds 4711 1913
+
+/run/initialize
+
+/control/execute macros/init_data.mac
+/daq/output_file   {output}
+{data}
+/profile/startup_file       {directory}/{name}_startup.json
+/profile/run_summary_file   {directory}/{name}_run.json
+/profile/progress_interval  0 s
+
+/run/beamOn {events}
+"""
+
+module_geometry = "/control/execute macros/init_geom.mac"
+
+# init_geom.mac places the PMTs of both hemispheres, the hemisphere only gets the first eight
+hemisphere_geometry = """
+/geometry/gdml/file            geometry/P-OM_hemisphere_v13/mother.gdml
+/geometry/gdml/submerge        true
+/geometry/gdml/submergeMode    boolean
+/geometry/gdml/envelope        true
+/geometry/PMT/PCTubeSize       3 mm
+/geometry/PMT/setOrigin        80 0 0
+/geometry/PMT/setRefX          0 0 1
+/geometry/PMT/setRefY          1 0 0
+/geometry/PMT/place 199.90 32.5 0
+/geometry/PMT/place 199.90 32.5 90
+/geometry/PMT/place 199.90 32.5 180
+/geometry/PMT/place 199.90 32.5 270
+/geometry/PMT/place 199.90 65 45
+/geometry/PMT/place 199.90 65 135
+/geometry/PMT/place 199.90 65 225
+/geometry/PMT/place 199.90 65 315
+"""
+
+# all tracks with path lengths, no filters
+output_heavy_data = """
+/daq/output_mode    tracks
+/daq/path_lengths   true
+/daq/glass_filter   false
+/daq/photons_filter false
+"""
+
+scenarios = {
+    "photon_module":     dict(physics="optical", primary="macros/init_primary_photon.mac", geometry=module_geometry,     events=200000, output=None, data=""),
+    "photon_hemisphere": dict(physics="optical", primary="macros/init_primary_photon.mac", geometry=hemisphere_geometry, events=200000, output=None, data=""),
+    "muon":              dict(physics="em",      primary="macros/init_primary_mu.mac",     geometry=module_geometry,     events=20,     output=None, data=""),
+    "startup":           dict(physics="optical", primary="macros/init_primary_photon.mac", geometry=module_geometry,     events=0,      output=None, data=""),
+    "output_heavy":      dict(physics="optical", primary="macros/init_primary_photon.mac", geometry=module_geometry,     events=200000, output="output_heavy.csv", data=output_heavy_data),
+}
+
+# metric: True if larger is better
+metrics = {"events_per_s": True, "steps_per_s": True, "startup_s": False, "peak_rss_mb": False}
+
+
+def run(executable, name, scenario, directory, scale):
+    macro  = os.path.join(directory, f"{name}.mac")
+    output = os.path.join(directory, scenario["output"]) if scenario["output"] else "/dev/null"
+    events = int(scenario["events"] * scale)
+
+    with open(macro, "w") as f:
+        f.write(macro_template.format(primary=scenario["primary"], geometry=scenario["geometry"], output=output, data=scenario["data"],
+                                      directory=directory, name=name, events=events))
+
+    start = time.time()
+    with open(os.path.join(directory, f"{name}.log"), "w") as log:
+        subprocess.run([executable, "--batch", macro, "--physics", scenario["physics"]], stdout=log, stderr=subprocess.STDOUT, check=True)
+    total = time.time() - start
+
+    with open(os.path.join(directory, f"{name}_startup.json")) as f:
+        startup = json.load(f)
+
+    # /run/beamOn 0 only initializes, there is no run and no run summary
+    summary = {"events": 0, "steps": 0, "events_per_s": 0, "steps_per_s": 0, "peak_rss_mb": startup["peak_rss_mb"]}
+    if events > 0:
+        with open(os.path.join(directory, f"{name}_run.json")) as f:
+            summary = json.load(f)
+
+    return {"events":       summary["events"],
+            "steps":        summary["steps"],
+            "events_per_s": summary["events_per_s"],
+            "steps_per_s":  summary["steps_per_s"],
+            "startup_s":    startup["wall_s"],
+            "peak_rss_mb":  summary["peak_rss_mb"],
+            "total_s":      total}
+
+
+def compare(results, baseline, tolerance):
+    regressions = []
+    print(f"\n{'scenario':20s}{'metric':14s}{'baseline':>14s}{'current':>14s}{'change':>10s}")
+    for name, result in results.items():
+        if name not in baseline:
+            continue
+        for metric, larger_is_better in metrics.items():
+            reference, current = baseline[name].get(metric, 0), result[metric]
+            if reference <= 0:
+                continue
+            change = current / reference - 1
+            regressed = change < -tolerance if larger_is_better else change > tolerance
+            flag = "  REGRESSION" if regressed else ""
+            print(f"{name:20s}{metric:14s}{reference:14.4g}{current:14.4g}{100 * change:9.1f}%{flag}")
+            if regressed:
+                regressions.append((name, metric))
+    return regressions
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--executable",    default="./optical_module")
+    parser.add_argument("--directory",     default="benchmark", help="where macros, logs and results are written")
+    parser.add_argument("--scenarios",     default=",".join(scenarios), help="comma separated subset of " + ",".join(scenarios))
+    parser.add_argument("--scale",         default=1.0, type=float, help="factor on the number of events of all scenarios")
+    parser.add_argument("--baseline",      default=None, help="results of an earlier run to compare against")
+    parser.add_argument("--tolerance",     default=0.1, type=float, help="relative change of a metric that counts as regression")
+    parser.add_argument("--save-baseline", action="store_true", help="write the results to the baseline file instead of comparing")
+    args = parser.parse_args()
+
+    os.makedirs(args.directory, exist_ok=True)
+    directory = os.path.abspath(args.directory)
+    executable = os.path.abspath(args.executable)
+
+    results = {}
+    for name in args.scenarios.split(","):
+        print(f"running {name} ...", flush=True)
+        results[name] = run(executable, name, scenarios[name], directory, args.scale)
+
+    print(f"\n{'scenario':20s}{'events/s':>12s}{'steps/s':>14s}{'startup [s]':>13s}{'peak RSS [MB]':>15s}")
+    for name, result in results.items():
+        print(f"{name:20s}{result['events_per_s']:12.1f}{result['steps_per_s']:14.0f}{result['startup_s']:13.2f}{result['peak_rss_mb']:15.1f}")
+
+    with open(os.path.join(directory, "results.json"), "w") as f:
+        json.dump(results, f, indent=2)
+    print(f"\nresults written to {os.path.join(directory, 'results.json')}")
+
+    if args.baseline is None:
+        sys.exit(0)
+
+    if args.save_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(results, f, indent=2)
+        print(f"baseline written to {args.baseline}")
+        sys.exit(0)
+
+    if not os.path.exists(args.baseline):
+        print(f"no baseline {args.baseline}, create one with --save-baseline")
+        sys.exit(0)
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+
+    regressions = compare(results, baseline, args.tolerance)
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) beyond {100 * args.tolerance:.0f} %")
+        sys.exit(1)
+    print(f"\nno regressions beyond {100 * args.tolerance:.0f} %")
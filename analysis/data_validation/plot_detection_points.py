@@ -10,7 +10,7 @@ df = pd.read_csv("P-OM/data/out_photons.csv")
 pmt_colors = plt.cm.tab20(np.linspace(0, 1, 16))
 
 # filter DataFrame to only include photon absorption events in a photocathode
-photocathode_df = df[(df["out_VolumeName"] == "photocathode") & (df["out_ProcessName"] == "OpAbsorption")]
+photocathode_df = df[(df["out_VolumeName"] == "photocathode") & (df["out_ProcessName"].isin(["OpAbsorption", "FastPMT"]))]
 
 # create a 3D scatter plot of the photon absorption events
 fig = plt.figure()
@@ -32,7 +32,7 @@ df = pd.DataFrame()
 
 for file in data_files:
     df_temp = pd.read_csv(file)
-    df_temp = df_temp.query("PID == -22 and g_x != 0 and g_y != 0 and g_z != 0 and out_ProcessName == 'OpAbsorption' and out_VolumeName.str.contains('photocathode')")
+    df_temp = df_temp.query("PID == -22 and g_x != 0 and g_y != 0 and g_z != 0 and out_ProcessName in ['OpAbsorption', 'FastPMT'] and out_VolumeName.str.contains('photocathode')")
     df = pd.concat([df, df_temp], ignore_index=True)
 flange_thickness = 90 # mm
 df['g_z'] = df['g_z'] - flange_thickness/2 * np.sign(df["g_z"])
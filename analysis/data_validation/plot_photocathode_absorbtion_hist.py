@@ -7,7 +7,7 @@ import matplotlib.pyplot as plt
 df = pd.read_csv("P-OM/data/out00.csv")
 
 # filter DataFrame to only include photon absorption events in a photocathode
-photocathode_df = df[(df["out_VolumeName"].str.contains("photocathode")) & (df["out_ProcessName"] == "OpAbsorption")]
+photocathode_df = df[(df["out_VolumeName"].str.contains("photocathode")) & (df["out_ProcessName"].isin(["OpAbsorption", "FastPMT"]))]
 
 # Extract the copy number of the photocathode where the particle was absorbed
 photocathode_copy_number = photocathode_df['out_Volume_CopyNo']
@@ -45,7 +45,7 @@ for i, pmt in pmt_positions.items():
                                                 * np.cos(photons_pos_angles[:,0]  - np.deg2rad(pmt[0])))
     
     photons_above_pmt = np.sum(photons_angular_distances_to_pmt < threshold_rad)
-    photons_above_pmt_detected = df[(df['out_ProcessName'] == 'OpAbsorption')
+    photons_above_pmt_detected = df[(df['out_ProcessName'].isin(['OpAbsorption', 'FastPMT']))
                                   & (df['out_VolumeName'].str.contains('photocathode'))
                                   & (df['out_Volume_CopyNo'] == i)
                                   & (photons_angular_distances_to_pmt < threshold_rad)].shape[0]
@@ -0,0 +1,63 @@
+import numpy as np
+
+# layout of OMPhaseSpaceHeader / OMPhaseSpaceRecord (include/OMPhaseSpace.hh)
+header_dtype = np.dtype([
+    ("magic",         "S8"),
+    ("record_size",   "<u4"),
+    ("reserved",      "<u4"),
+    ("nr_of_records", "<u8"),
+    ("radius",        "<f8"),
+    ("centre",        "<f8", 3),
+])
+
+record_dtype = np.dtype([
+    ("position",     "<f4", 3),   # mm
+    ("direction",    "<f4", 3),
+    ("polarisation", "<f4", 3),
+    ("energy",       "<f4"),      # eV
+    ("time",         "<f4"),      # ns
+    ("weight",       "<f4"),
+])
+
+
+def write_primary_list(filename, records, radius=0, centre=(0, 0, 0)):
+    """write a structured array of record_dtype, to be read with /primary/mode list"""
+    header = np.zeros(1, dtype=header_dtype)
+    header["magic"]         = b"OMPHSP1"
+    header["record_size"]   = record_dtype.itemsize
+    header["nr_of_records"] = len(records)
+    header["radius"]        = radius
+    header["centre"]        = centre
+    with open(filename, "wb") as f:
+        f.write(header.tobytes())
+        f.write(np.ascontiguousarray(records, dtype=record_dtype).tobytes())
+
+
+def read_primary_list(filename):
+    """memory map a primary list or recorded phase space"""
+    header  = np.fromfile(filename, dtype=header_dtype, count=1)[0]
+    records = np.memmap(filename, dtype=record_dtype, mode="r", offset=header_dtype.itemsize, shape=(int(header["nr_of_records"]),))
+    return header, records
+
+
+if __name__ == "__main__":
+
+    # example: photons on a sphere of 40 cm radius pointing towards the module
+    n      = 1000000
+    radius = 400 # mm
+
+    pos = np.random.normal(size=(n, 3))
+    pos = radius * pos / np.linalg.norm(pos, axis=1)[:, None]
+
+    pol = np.cross(pos, np.random.normal(size=(n, 3)))
+    pol = pol / np.linalg.norm(pol, axis=1)[:, None]
+
+    records = np.zeros(n, dtype=record_dtype)
+    records["position"]     = pos
+    records["direction"]    = - pos / radius
+    records["polarisation"] = pol
+    records["energy"]       = np.random.normal(3.0, 0.3, n)
+    records["time"]         = 0
+    records["weight"]       = 1
+
+    write_primary_list("P-OM/data/primaries.bin", records, radius)
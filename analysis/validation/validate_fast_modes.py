@@ -0,0 +1,252 @@
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+
+import numpy as np
+import pandas as pd
+
+# physics equivalence of a fast mode: runs a reference and a candidate configuration with the same number of primary photons
+# and compares the per-PMT acceptance (chi-square), the arrival times of the hits and the glass contact distributions
+# (Kolmogorov-Smirnov). Reports the speedup and every deviation that is significant at --alpha; exits with 1 if there is one.
+# Run from the build directory, e.g.
+# python3 ../analysis/validation/validate_fast_modes.py --candidate fast_pmt --events 1000000
+
+macro_template = """
+/control/execute macros/init_physics.mac
+/control/execute macros/init_primary_photon.mac
+/control/execute macros/init_geom.mac
+{geometry}
+
+/random/setSeeds {seed} 1913
+
+/run/initialize
+
+/control/execute macros/init_data.mac
+/daq/output_file          {output}
+/daq/output_mode          {mode}
+/daq/path_lengths         false
+/daq/outProcess_filter    nan
+/daq/outVolume_filter     nan
+/daq/glass_filter         true
+/daq/photons_filter       true
+/daq/trigger/enable       false
+/profile/run_summary_file {summary}
+/profile/progress_interval 0 s
+
+/run/beamOn {events}
+"""
+
+# settings on top of init_geom.mac, the reference is init_geom.mac as it is. QE weighting is no preset: it replaces the
+# photocathode absorption by the photoQE curve, a different detector response that would always deviate
+presets = {
+    "reference":      "",
+    "fast_pmt":       "/geometry/PMT/fastModel fast",
+    "decimation":     "/geometry/gdml/decimation 0.05 mm",
+    "primitives":     "/geometry/gdml/primitives 0.2 mm",
+    "shared_gelpads": "/geometry/PMT/sharedGelpads 0.2 mm",
+    "flatten":        "/geometry/PMT/flatten true",
+    "hull":           "/geometry/gdml/submergeMode hull",
+}
+
+
+#-----------
+# statistics, without scipy
+#-----------
+
+def chi2_sf(x, dof):
+    # upper regularized incomplete gamma Q(dof/2, x/2): series below a + 1, continued fraction above
+    a, x = dof / 2, x / 2
+    if x <= 0:
+        return 1.0
+    log_prefactor = a * math.log(x) - x - math.lgamma(a)
+    if x < a + 1:
+        term = total = 1 / a
+        for n in range(1, 1000):
+            term *= x / (a + n)
+            total += term
+            if abs(term) < abs(total) * 1e-15:
+                break
+        return max(0.0, 1 - total * math.exp(log_prefactor))
+    b, c, d = x + 1 - a, 1e300, 1 / (x + 1 - a)
+    h = d
+    for n in range(1, 1000):
+        an = -n * (n - a)
+        b += 2
+        d = an * d + b
+        d = 1e-300 if abs(d) < 1e-300 else d
+        c = b + an / c
+        c = 1e-300 if abs(c) < 1e-300 else c
+        d = 1 / d
+        h *= d * c
+        if abs(d * c - 1) < 1e-15:
+            break
+    return math.exp(log_prefactor) * h
+
+
+def kolmogorov_sf(x):
+    if x < 0.2:
+        return 1.0
+    return max(0.0, min(1.0, 2 * sum((-1) ** (k - 1) * math.exp(-2 * k * k * x * x) for k in range(1, 101))))
+
+
+def ks_test(a, b, weights_a=None, weights_b=None):
+    # two sample KS test with weighted empirical distributions, effective sample sizes (sum w)^2 / sum w^2
+    weights_a = np.ones(len(a)) if weights_a is None else np.asarray(weights_a, dtype=float)
+    weights_b = np.ones(len(b)) if weights_b is None else np.asarray(weights_b, dtype=float)
+    if len(a) == 0 or len(b) == 0:
+        return float("nan"), 1.0
+
+    order_a, order_b = np.argsort(a), np.argsort(b)
+    a, weights_a = np.asarray(a)[order_a], weights_a[order_a]
+    b, weights_b = np.asarray(b)[order_b], weights_b[order_b]
+    cdf_a = np.concatenate([[0], np.cumsum(weights_a) / weights_a.sum()])
+    cdf_b = np.concatenate([[0], np.cumsum(weights_b) / weights_b.sum()])
+
+    values   = np.concatenate([a, b])
+    distance = np.max(np.abs(cdf_a[np.searchsorted(a, values, side="right")] - cdf_b[np.searchsorted(b, values, side="right")]))
+
+    n_a = weights_a.sum() ** 2 / (weights_a ** 2).sum()
+    n_b = weights_b.sum() ** 2 / (weights_b ** 2).sum()
+    n   = math.sqrt(n_a * n_b / (n_a + n_b))
+    return distance, kolmogorov_sf((n + 0.12 + 0.11 / n) * distance)
+
+
+def acceptance_test(reference, candidate, events):
+    # both runs have the same number of primaries: per channel difference of the summed weights over its error
+    channels = sorted(set(reference["channel"]) | set(candidate["channel"]))
+    rows = []
+    for channel in channels:
+        w_r = reference.loc[reference["channel"] == channel, "weight"]
+        w_c = candidate.loc[candidate["channel"] == channel, "weight"]
+        variance = (w_r ** 2).sum() + (w_c ** 2).sum()
+        z = (w_c.sum() - w_r.sum()) / math.sqrt(variance) if variance > 0 else 0.0
+        rows.append({"channel": int(channel), "reference": w_r.sum() / events, "candidate": w_c.sum() / events, "z": z})
+    table = pd.DataFrame(rows, columns=["channel", "reference", "candidate", "z"])
+    chi2  = float((table["z"] ** 2).sum())
+    return table, chi2, len(table), chi2_sf(chi2, len(table)) if len(table) > 0 else 1.0
+
+
+#-----------
+# runs
+#-----------
+
+def run(executable, name, geometry, physics, mode, events, seed, directory):
+    macro   = os.path.join(directory, f"{name}_{mode}.mac")
+    output  = os.path.join(directory, f"{name}_{mode}.csv")
+    summary = os.path.join(directory, f"{name}_{mode}_run.json")
+
+    with open(macro, "w") as f:
+        f.write(macro_template.format(geometry=geometry, seed=seed, output=output, mode=mode, summary=summary, events=events))
+
+    with open(os.path.join(directory, f"{name}_{mode}.log"), "w") as log:
+        subprocess.run([executable, "--batch", macro, "--physics", physics], stdout=log, stderr=subprocess.STDOUT, check=True)
+
+    with open(summary) as f:
+        return pd.read_csv(output), json.load(f)
+
+
+def glass_observables(tracks):
+    # the module axis is x (hemisphere origins at +-80 mm), contact position in polar/azimuth angle around it and
+    # the angle of the photon to the radial direction at the contact point
+    position  = tracks[["g_x", "g_y", "g_z"]].to_numpy()
+    direction = tracks[["g_px", "g_py", "g_pz"]].to_numpy()
+    radius    = np.linalg.norm(position, axis=1)
+    return {"cos_theta":     position[:, 0] / radius,
+            "phi":           np.arctan2(position[:, 2], position[:, 1]),
+            "cos_incidence": -np.sum(position * direction, axis=1) / radius}
+
+
+def geometry_settings(candidate):
+    if candidate in presets:
+        return presets[candidate]
+    # anything else is a macro with settings on top of init_geom.mac
+    with open(candidate) as f:
+        return f.read()
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--executable", default="./optical_module")
+    parser.add_argument("--candidate",  required=True, help="one of " + ", ".join(presets) + " or a macro with geometry settings")
+    parser.add_argument("--reference",  default="reference", help="same as --candidate, init_geom.mac as it is by default")
+    parser.add_argument("--physics",    default="optical", help="physics list of both runs")
+    parser.add_argument("--events",     default=1000000, type=int, help="primary photons per run")
+    parser.add_argument("--alpha",      default=0.01, type=float, help="p-value below which a deviation counts as significant")
+    parser.add_argument("--no-glass",   action="store_true", help="skip the tracks runs for the glass contact distributions")
+    parser.add_argument("--directory",  default="validation", help="where macros, logs, output and the report are written")
+    args = parser.parse_args()
+
+    os.makedirs(args.directory, exist_ok=True)
+    directory  = os.path.abspath(args.directory)
+    executable = os.path.abspath(args.executable)
+
+    # independent seeds, the tests assume independent samples
+    configurations = {"reference": (geometry_settings(args.reference), 4711),
+                      "candidate": (geometry_settings(args.candidate), 4712)}
+
+    hits, speed, tracks = {}, {}, {}
+    for name, (geometry, seed) in configurations.items():
+        print(f"running {name} (hits) ...", flush=True)
+        hits[name], speed[name] = run(executable, name, geometry, args.physics, "hits", args.events, seed, directory)
+        if not args.no_glass:
+            print(f"running {name} (tracks) ...", flush=True)
+            tracks[name], _ = run(executable, name, geometry, args.physics, "tracks", args.events, seed, directory)
+
+    tests = []
+
+    # per PMT acceptance
+    table, chi2, dof, p = acceptance_test(hits["reference"], hits["candidate"], args.events)
+    tests.append({"test": "acceptance per channel", "statistic": chi2, "dof": dof, "p": p})
+    print(f"\n{'channel':>8s}{'reference':>14s}{'candidate':>14s}{'z':>8s}")
+    for row in table.itertuples():
+        flag = "  *" if abs(row.z) > 3 else ""
+        print(f"{row.channel:8d}{row.reference:14.6f}{row.candidate:14.6f}{row.z:8.2f}{flag}")
+
+    # arrival times of all hits and per channel, the per channel threshold is corrected for the number of channels
+    reference, candidate = hits["reference"], hits["candidate"]
+    distance, p = ks_test(reference["t"], candidate["t"], reference["weight"], candidate["weight"])
+    tests.append({"test": "arrival time", "statistic": distance, "p": p})
+    for channel in table["channel"]:
+        r, c = reference[reference["channel"] == channel], candidate[candidate["channel"] == channel]
+        distance, p = ks_test(r["t"], c["t"], r["weight"], c["weight"])
+        tests.append({"test": f"arrival time channel {channel}", "statistic": distance, "p": p, "trials": len(table)})
+
+    # glass contacts: rate and distributions
+    if not args.no_glass:
+        n_r, n_c = len(tracks["reference"]), len(tracks["candidate"])
+        z = (n_c - n_r) / math.sqrt(max(n_r + n_c, 1))
+        tests.append({"test": "glass contact rate", "statistic": z, "p": math.erfc(abs(z) / math.sqrt(2))})
+        observables_r, observables_c = glass_observables(tracks["reference"]), glass_observables(tracks["candidate"])
+        for observable in observables_r:
+            distance, p = ks_test(observables_r[observable], observables_c[observable])
+            tests.append({"test": f"glass contact {observable}", "statistic": distance, "p": p})
+
+    for test in tests:
+        test["significant"] = bool(test["p"] < args.alpha / test.get("trials", 1))
+    significant = [test for test in tests if test["significant"]]
+
+    print(f"\n{'test':32s}{'statistic':>12s}{'p':>12s}")
+    for test in tests:
+        if test["test"].startswith("arrival time channel") and not test["significant"]:
+            continue
+        flag = "  SIGNIFICANT" if test["significant"] else ""
+        print(f"{test['test']:32s}{test['statistic']:12.4g}{test['p']:12.3g}{flag}")
+
+    speedup = speed["candidate"]["events_per_s"] / speed["reference"]["events_per_s"]
+    print(f"\nreference: {speed['reference']['events_per_s']:.1f} events/s, candidate: {speed['candidate']['events_per_s']:.1f} events/s, "
+          f"speedup {speedup:.3f}")
+
+    report = {"reference": args.reference, "candidate": args.candidate, "events": args.events, "alpha": args.alpha,
+              "speedup": speedup, "speed": speed, "acceptance": table.to_dict(orient="records"), "tests": tests}
+    with open(os.path.join(directory, "validation.json"), "w") as f:
+        json.dump(report, f, indent=2)
+    print(f"report written to {os.path.join(directory, 'validation.json')}")
+
+    if significant:
+        print(f"\n{len(significant)} significant deviation(s) at alpha = {args.alpha}")
+        sys.exit(1)
+    print(f"\nno significant deviation at alpha = {args.alpha}")
@@ -7,7 +7,10 @@
 // G4 includes
 #include "G4Material.hh"
 #include "G4RotationMatrix.hh"
+#include "G4Transform3D.hh"
 #include "G4VUserDetectorConstruction.hh"
+#include "G4OpticalSurface.hh"
+#include "G4Colour.hh"
 #include "globals.hh"
 
 // project includes
@@ -32,11 +35,19 @@ class OMConstruction : public G4VUserDetectorConstruction
 
         // member functions
         G4VPhysicalVolume* Construct();
+        void ConstructSDandField();
         void submerge();
+        G4bool submergeConvexHull();   // false if the hull can not replace the boolean water volume
         void constructGelpad();
         void constructPMT();
         void placeOpticalUnits();
+        void placeSolidReflectors();
+        void createEnvelope();
+        void readGDML();
         void configureGDMLObjects();
+        void deduplicateGDMLObjects();
+        void decimateGDMLObjects();
+        void fitGDMLPrimitives();
         void addOpticalUnit(G4double, G4double, G4double);
 
         // inline stuff
@@ -49,6 +60,22 @@ class OMConstruction : public G4VUserDetectorConstruction
         void setPhotocathodeTubeLength(G4double size){this->_photocathode_tube_length = size;};
 
         G4String getGDMLFilename(){return this->_gdml_filename;};
+
+        void     setGDMLCacheDirectory(G4String directory){this->_gdml_cache_directory = directory;};
+        G4String getGDMLCacheDirectory(){return this->_gdml_cache_directory;};
+
+        void     setGDMLThreads(G4int val){this->_gdml_threads = val;};
+        G4int    getGDMLThreads(){return this->_gdml_threads;};
+
+        void     setDeduplicate(G4bool val){this->_deduplicate = val;};
+        G4bool   getDeduplicate(){return this->_deduplicate;};
+
+        void     setDecimationTolerance(G4double val){this->_decimation_tolerance = val;};
+        G4double getDecimationTolerance(){return this->_decimation_tolerance;};
+
+        void     setPrimitiveTolerance(G4double val){this->_primitive_tolerance = val;};
+        G4double getPrimitiveTolerance(){return this->_primitive_tolerance;};
+
         G4ThreeVector getOUCoordCenter(){return this->_ou_coord_center;};
         G4ThreeVector getOUCoordRefX(){return this->_ou_coord_refX;};
         G4ThreeVector getOUCoordRefY(){return this->_ou_coord_refY;};
@@ -56,34 +83,113 @@ class OMConstruction : public G4VUserDetectorConstruction
         G4bool getSubmerge(){return this->_submerge;};
         void   setSubmerge(G4bool val){this->_submerge = val;};
 
+        G4String getSubmergeMode(){return this->_submerge_mode;};
+        void     setSubmergeMode(G4String val){this->_submerge_mode = val;};
+
+        G4bool getEnvelope(){return this->_envelope;};
+        void   setEnvelope(G4bool val){this->_envelope = val;};
+
         G4bool getSolidReflector(){return this->_solidReflector;};
         void   setSolidReflector(G4bool val){this->_solidReflector = val;};
 
+        G4bool getQEWeighting(){return this->_qe_weighting;};
+        void   setQEWeighting(G4bool val){this->_qe_weighting = val;};
+
+        G4bool getFlattenPMT(){return this->_flatten_pmt;};
+        void   setFlattenPMT(G4bool val){this->_flatten_pmt = val;};
+
+        G4String getFastPMTMode(){return this->_fast_pmt_mode;};
+        void     setFastPMTMode(G4String val){this->_fast_pmt_mode = val;};
+
+        G4String getPMTResponseFile(){return this->_pmt_response_file;};
+        void     setPMTResponseFile(G4String val){this->_pmt_response_file = val;};
+
+        G4String getNavigationFile(){return this->_navigation_file;};
+        void     setNavigationFile(G4String val){this->_navigation_file = val;};
+
+        G4bool   getNavigationTuning(){return this->_navigation_tuning;};
+        void     setNavigationTuning(G4bool val){this->_navigation_tuning = val;};
+
+        G4int    getNavigationRays(){return this->_navigation_rays;};
+        void     setNavigationRays(G4int val){this->_navigation_rays = val;};
+
+        void     setGelpadTolerance(G4double val){this->_gelpad_tolerance = val;};
+        G4double getGelpadTolerance(){return this->_gelpad_tolerance;};
+
 
     private:
 
+        // material, reflection and visual properties of an imported object, depending on its name
+        struct GDMLObjectProperties
+        {
+            G4Material*       material;
+            G4OpticalSurface* surface;
+            G4Colour          colour;
+            G4bool            visible;
+        };
+
+        GDMLObjectProperties getGDMLObjectProperties(const G4String& obj_name);
+
+        // points whose convex hull encloses the placed solid, in the frame of its mother volume
+        std::vector<G4ThreeVector> getEnclosingPoints(G4VPhysicalVolume* physical);
+
+        // moves a placement to the given transform, reusing its rotation matrix
+        void setPlacement(G4VPhysicalVolume* physical, const G4Transform3D& placement);
+
+        // gelpad cut by a sphere fitted to the glass above it, shared by all optical units with the same curvature
+        struct SharedGelpad
+        {
+            G4ThreeVector     centre;   // of the glass sphere, in the gelpad frame
+            G4double          radius;
+            G4LogicalVolume*  logical;
+        };
+
+        G4LogicalVolume* getSharedGelpad(const std::vector<std::pair<G4VSolid*, G4Transform3D>>& glass_parts, const G4Transform3D& pmt_offset);
+
         OMMaterialManager*                _MaterialManager;
         OMConstructionMessenger*          _ConstructionMessenger;
 
         G4bool                            _submerge;
+        G4String                          _submerge_mode;
+        G4bool                            _envelope;
         G4bool                            _solidReflector;
+        G4bool                            _qe_weighting;
+        G4bool                            _flatten_pmt;
+        G4String                          _fast_pmt_mode;       // off, generate or fast
+        G4String                          _pmt_response_file;
+        G4ThreeVector                     _photocathode_centre; // in the PMT frame, reference of the response table
+        G4String                          _navigation_file;     // tuned smartless and voxel settings
+        G4bool                            _navigation_tuning;   // tune and write instead of applying the file
+        G4int                             _navigation_rays;
 
         G4VPhysicalVolume*                _world_phsical;
         G4LogicalVolume*                  _world_logical;
+        G4VPhysicalVolume*                _module_physical;   // envelope around the module, or the world without envelope
+        G4LogicalVolume*                  _module_logical;
+        G4VPhysicalVolume*                _interior_physical; // air inside the housing, if submerged by convex hull
         G4VSolid*                         _gelpad_solid;
         G4LogicalVolume*                  _pmt_logical;
+        std::vector<G4LogicalVolume*>     _photocathode_logicals;
 
         G4int                             _nr_of_OUs;
         std::vector<G4VPhysicalVolume*>   _placed_gelpads;
         std::vector<G4VPhysicalVolume*>   _placed_pmts;
+        std::vector<G4RotationMatrix*>    _placement_rotations;   // allocated by setPlacement for placements without rotation
 
         G4String                          _gdml_filename;
+        G4String                          _gdml_cache_directory;
+        G4int                             _gdml_threads;
+        G4bool                            _deduplicate;
+        G4double                          _decimation_tolerance;
+        G4double                          _primitive_tolerance;
 
         G4ThreeVector                     _ou_coord_center;
         G4ThreeVector                     _ou_coord_refX;
         G4ThreeVector                     _ou_coord_refY;
 
         G4double                          _gelpad_ring_offset;
+        G4double                          _gelpad_tolerance;
+        std::vector<SharedGelpad>         _shared_gelpads;
         G4double                          _photocathode_tube_length;
 
         std::vector<G4ThreeVector>        _ou_centers;
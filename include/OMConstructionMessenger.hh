@@ -9,6 +9,7 @@
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWith3Vector.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 
 // project includes
@@ -36,11 +37,19 @@ class OMConstructionMessenger: public G4UImessenger
         // menu dirs
         G4UIdirectory* GDMLDir;
         G4UIdirectory* OpticalUnitDir;
+        G4UIdirectory* NavigationDir;
 
         // commands
         G4UIcmdWithABool*     submergeCmd;
+        G4UIcmdWithABool*     envelopeCmd;
+        G4UIcmdWithAString*   submergeModeCmd;
         G4UIcmdWithABool*     solidReflectorCmd;
         G4UIcmdWithAString*   gdmlfileCmd;
+        G4UIcmdWithAString*   gdmlCacheCmd;
+        G4UIcmdWithAnInteger* gdmlThreadsCmd;
+        G4UIcmdWithABool*     deduplicateCmd;
+        G4UIcmdWithADoubleAndUnit* decimationCmd;
+        G4UIcmdWithADoubleAndUnit* primitivesCmd;
 
         G4UIcmdWith3Vector*   OUOrgCmd;
         G4UIcmdWith3Vector*   OURefXCmd;
@@ -49,6 +58,15 @@ class OMConstructionMessenger: public G4UImessenger
 
         G4UIcmdWithADoubleAndUnit*   GelRingCmd;
         G4UIcmdWithADoubleAndUnit*   PhotocathodeTubeCmd;
+        G4UIcmdWithABool*            QEWeightingCmd;
+        G4UIcmdWithADoubleAndUnit*   sharedGelpadsCmd;
+        G4UIcmdWithABool*            flattenPMTCmd;
+        G4UIcmdWithAString*          fastPMTCmd;
+        G4UIcmdWithAString*          PMTResponseCmd;
+
+        G4UIcmdWithAString*          navigationFileCmd;
+        G4UIcmdWithABool*            navigationTuneCmd;
+        G4UIcmdWithAnInteger*        navigationRaysCmd;
 
 
 };
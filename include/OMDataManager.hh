@@ -3,15 +3,21 @@
 
 // system includes
 #include <fstream>
+#include <sstream>
+#include <vector>
+#include <utility>
 
 // G4 Includes
 #include "G4ThreeVector.hh"
+#include "G4Material.hh"
 
 //ROOT includes
 //#include "TTree.h" // TODO use this later
 
 // Project includes
 #include "OMDataManagerMessenger.hh"
+#include "OMPhotocathodeHit.hh"
+#include "OMPhaseSpace.hh"
 
 // forward declarations
 class OMDataManagerMessenger;
@@ -28,6 +34,10 @@ class OMDataManager
         void close();
         void setFilename(G4String val);
 
+        void beginEvent();
+        void endEvent(G4int event_id, OMPhotocathodeHitsCollection* hits);
+        void printTriggerSummary();
+
         // inline from here on
 
         G4String getFilename(){return this->_filename;};
@@ -45,6 +55,75 @@ class OMDataManager
         void   setPhotonsFilter(G4bool val){this->_filter_photons = val;};
         G4bool setPhotonsFilter(){return this->_filter_photons;};
 
+        void   setOutputMode(G4String val){this->_hits_output = (val == "hits");};
+        G4bool getHitsOutput(){return this->_hits_output;};
+
+        void   setTriggerEnabled(G4bool val){this->_trigger_enabled = val;};
+        G4bool getTriggerEnabled(){return this->_trigger_enabled;};
+
+        void   setTriggerMultiplicity(G4int val){this->_trigger_multiplicity = val;};
+        G4int  getTriggerMultiplicity(){return this->_trigger_multiplicity;};
+
+        void     setTriggerWindow(G4double val){this->_trigger_window = val;};
+        G4double getTriggerWindow(){return this->_trigger_window;};
+
+        void   setRecordPathLengths(G4bool val){this->_record_path_lengths = val;};
+        G4bool getRecordPathLengths(){return this->_record_path_lengths;};
+
+        // path length of the current photon in water, glass, gel and vacuum
+        const G4double* getPathLengths(){return this->_current_path_length;};
+
+        void addPathLength(const G4Material* material, G4double length)
+        {size_t index = material->GetIndex();
+         if (index >= this->_material_slot.size() || this->_material_slot[index] < 0) return;
+         this->_current_path_length[this->_material_slot[index]] += length;};
+
+        void resetPathLengths()
+        {for (G4int i = 0; i < OMPhotocathodeHit::nr_of_path_materials; i++) this->_current_path_length[i] = 0;};
+
+        void     setPhaseSpaceFilename(G4String val){this->_phasespace_filename = val;};
+        G4String getPhaseSpaceFilename(){return this->_phasespace_filename;};
+
+        void     setPhaseSpaceRadius(G4double val){this->_phasespace_radius = val;};
+        G4double getPhaseSpaceRadius(){return this->_phasespace_radius;};
+
+        void          setPhaseSpaceCentre(G4ThreeVector val){this->_phasespace_centre = val;};
+        G4ThreeVector getPhaseSpaceCentre(){return this->_phasespace_centre;};
+
+        void   setPhaseSpaceKill(G4bool val){this->_phasespace_kill = val;};
+        G4bool getPhaseSpaceKill(){return this->_phasespace_kill;};
+
+        // photons are recorded on their first inward crossing of the sphere only
+        G4bool getRecordPhaseSpace(){return this->_phasespace_writer.isOpen() && !this->_current_phasespace_recorded;};
+
+        void phaseSpaceHandover(G4ThreeVector position, G4ThreeVector direction, G4ThreeVector polarisation, G4double energy, G4double time, G4double weight)
+        {OMPhaseSpaceRecord record;
+         for (G4int i = 0; i < 3; i++)
+         {record.position[i]     = position[i];
+          record.direction[i]    = direction[i];
+          record.polarisation[i] = polarisation[i];}
+         record.energy = energy;
+         record.time   = time;
+         record.weight = weight;
+         this->_phasespace_writer.write(record);
+         this->_current_phasespace_recorded = true;};
+
+        // number of steps and tracks in the current run, for the rates in the progress reports and run summary
+        void   countStep(){this->_nr_of_steps++;};
+        G4long getNrOfSteps(){return this->_nr_of_steps;};
+        G4long getNrOfTracks(){return this->_nr_of_tracks;};
+
+        // PMT copy nr if the fast PMT model detected the current photon, -1 otherwise
+        void  setFastPMTChannel(G4int val){this->_current_fast_pmt_channel = val;};
+        G4int getFastPMTChannel(){return this->_current_fast_pmt_channel;};
+
+        // per track state that is needed independent of the output mode
+        void beginTrack()
+        {this->resetPathLengths();
+         this->_nr_of_tracks++;
+         this->_current_phasespace_recorded = false;
+         this->_current_fast_pmt_channel    = -1;};
+
         G4bool doFiltersApply()
         {if (this->_filter_outProcess.find(this->_current_out_process_name) != std::string::npos) return true;
          if (this->_filter_outVolume.find(this->_current_out_volume_name)   != std::string::npos) return true;
@@ -76,32 +155,37 @@ class OMDataManager
 
         void write()
         {if (this->doFiltersApply()) return;
-         this->_File << this->_current_pid                   << ","
-                     << this->_current_in_time               << ","
-                     << this->_current_in_position[0]        << ","
-                     << this->_current_in_position[1]        << ","
-                     << this->_current_in_position[2]        << ","
-                     << this->_current_in_energy             << ","
-                     << this->_current_in_momentum[0]        << ","
-                     << this->_current_in_momentum[1]        << ","
-                     << this->_current_in_momentum[2]        << ","
-                     << this->_current_glass_contact_pos[0]  << ","
-                     << this->_current_glass_contact_pos[1]  << ","
-                     << this->_current_glass_contact_pos[2]  << ","
-                     << this->_current_glass_contact_dir[0]  << ","
-                     << this->_current_glass_contact_dir[1]  << ","
-                     << this->_current_glass_contact_dir[2]  << ","
-                     << this->_current_out_time              << ","
-                     << this->_current_out_position[0]       << ","
-                     << this->_current_out_position[1]       << ","
-                     << this->_current_out_position[2]       << ","
-                     << this->_current_out_energy            << ","
-                     << this->_current_out_momentum[0]       << ","
-                     << this->_current_out_momentum[1]       << ","
-                     << this->_current_out_momentum[2]       << ","
-                     << this->_current_out_volume_name       << ","
-                     << this->_current_out_volume_copyno     << ","
-                     << this->_current_out_process_name      << std::endl;};
+         // with an active trigger, records are held back until the trigger decision at the end of the event
+         std::ostream& out = this->_trigger_enabled ? static_cast<std::ostream&>(this->_event_buffer) : static_cast<std::ostream&>(this->_File);
+         out << this->_current_pid                   << ","
+             << this->_current_in_time               << ","
+             << this->_current_in_position[0]        << ","
+             << this->_current_in_position[1]        << ","
+             << this->_current_in_position[2]        << ","
+             << this->_current_in_energy             << ","
+             << this->_current_in_momentum[0]        << ","
+             << this->_current_in_momentum[1]        << ","
+             << this->_current_in_momentum[2]        << ","
+             << this->_current_glass_contact_pos[0]  << ","
+             << this->_current_glass_contact_pos[1]  << ","
+             << this->_current_glass_contact_pos[2]  << ","
+             << this->_current_glass_contact_dir[0]  << ","
+             << this->_current_glass_contact_dir[1]  << ","
+             << this->_current_glass_contact_dir[2]  << ","
+             << this->_current_out_time              << ","
+             << this->_current_out_position[0]       << ","
+             << this->_current_out_position[1]       << ","
+             << this->_current_out_position[2]       << ","
+             << this->_current_out_energy            << ","
+             << this->_current_out_momentum[0]       << ","
+             << this->_current_out_momentum[1]       << ","
+             << this->_current_out_momentum[2]       << ","
+             << this->_current_out_volume_name       << ","
+             << this->_current_out_volume_copyno     << ","
+             << this->_current_out_process_name;
+         if (this->_record_path_lengths)
+         {for (G4int i = 0; i < OMPhotocathodeHit::nr_of_path_materials; i++) out << "," << this->_current_path_length[i];}
+         out << std::endl;};
 
         void reset(){this->_current_pid                 = 0;
                      this->_current_in_time             = 0;
@@ -117,12 +201,15 @@ class OMDataManager
                      this->_current_out_momentum         = G4ThreeVector(0,0,0);
                      this->_current_out_volume_name     = "";
                      this->_current_out_volume_copyno   = 0 ;
-                     this->_current_out_process_name    = "";}
+                     this->_current_out_process_name    = "";
+                     this->resetPathLengths();}
 
 
     private:
 
         OMDataManager();
+        G4int getEventMultiplicity();
+        void  buildMaterialTable();
         static OMDataManager*   _instance;
         OMDataManagerMessenger* _DataManagerMessenger;
 
@@ -136,6 +223,32 @@ class OMDataManager
         G4bool        _filter_data_glass;
         G4bool        _filter_photons;
 
+        G4bool        _hits_output;       // write photocathode hits instead of one record per track
+
+        G4bool        _trigger_enabled;
+        G4int         _trigger_multiplicity;
+        G4double      _trigger_window;
+
+        std::ostringstream                  _event_buffer;
+        std::vector<std::pair<G4double,G4int>> _event_hits;    // (time, pmt copy nr) of photocathode hits in the current event
+
+        G4bool               _record_path_lengths;
+        std::vector<G4int>   _material_slot;                  // G4Material index -> slot in _current_path_length, -1 if not recorded
+
+        G4String             _phasespace_filename;
+        G4double             _phasespace_radius;
+        G4ThreeVector        _phasespace_centre;
+        G4bool               _phasespace_kill;
+        OMPhaseSpaceWriter   _phasespace_writer;
+        G4bool               _current_phasespace_recorded;
+        G4int                _current_fast_pmt_channel;
+
+        G4int                _nr_of_events;
+        G4int                _nr_of_triggered_events;
+        std::vector<G4int>   _multiplicity_counts;            // nr of events per maximum multiplicity within the trigger window
+        G4long               _nr_of_steps;
+        G4long               _nr_of_tracks;
+
         G4int         _current_pid;
 
         G4double      _current_in_time;
@@ -156,6 +269,7 @@ class OMDataManager
         G4int         _current_out_volume_copyno;
         G4String      _current_out_process_name;
 
+        G4double      _current_path_length[OMPhotocathodeHit::nr_of_path_materials];
 
 };
 #endif
@@ -7,6 +7,9 @@
 #include "G4UImessenger.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
 
 // project includes
 #include "OMDataManager.hh"
@@ -32,13 +35,26 @@ class OMDataManagerMessenger: public G4UImessenger
 
         // menu dirs
         G4UIdirectory* _dataDir;
+        G4UIdirectory* _triggerDir;
+        G4UIdirectory* _phaseSpaceDir;
 
         // commands
         G4UIcmdWithAString*   _outputFileCmd;
+        G4UIcmdWithAString*   _outputModeCmd;
         G4UIcmdWithAString*   _dataFilterOutProcessCmd;
         G4UIcmdWithAString*   _dataFilterOutVolumeCmd;
         G4UIcmdWithABool*     _dataFilterGlassCmd;
         G4UIcmdWithABool*     _dataFilterPhotonsCmd;
+        G4UIcmdWithABool*     _pathLengthsCmd;
+
+        G4UIcmdWithABool*            _triggerEnableCmd;
+        G4UIcmdWithAnInteger*        _triggerMultiplicityCmd;
+        G4UIcmdWithADoubleAndUnit*   _triggerWindowCmd;
+
+        G4UIcmdWithAString*          _phaseSpaceFileCmd;
+        G4UIcmdWithADoubleAndUnit*   _phaseSpaceRadiusCmd;
+        G4UIcmdWith3VectorAndUnit*   _phaseSpaceCentreCmd;
+        G4UIcmdWithABool*            _phaseSpaceKillCmd;
 
 };
 
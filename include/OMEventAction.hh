@@ -0,0 +1,29 @@
+#ifndef OM_EVENTACTION_H
+#define OM_EVENTACTION_H 1
+
+// system includes
+
+// G4 Includes
+#include "G4UserEventAction.hh"
+#include "G4Event.hh"
+
+//ROOT includes
+
+// Project includes
+
+class OMEventAction : public G4UserEventAction
+{
+    public:
+
+        OMEventAction();
+        ~OMEventAction();
+
+        void BeginOfEventAction(const G4Event*);
+        void EndOfEventAction(const G4Event*);
+
+    private:
+
+        G4int _photocathode_hc_id;
+
+};
+#endif
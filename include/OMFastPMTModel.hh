@@ -0,0 +1,37 @@
+#ifndef OM_FAST_PMT_MODEL_H
+#define OM_FAST_PMT_MODEL_H 1
+
+// system includes
+
+// G4 includes
+#include "G4VFastSimulationModel.hh"
+
+// project includes
+
+// forward declarations
+class OMPhotocathodeSD;
+
+/*  Fast simulation model on the PMT envelope. A photon entering a PMT is killed on the envelope, detection, delay and
+    detection point are sampled from the OMPMTResponse table. In generate mode, the model only records the entries
+    and the detailed PMT model fills the table */
+
+class OMFastPMTModel : public G4VFastSimulationModel
+{
+    public:
+
+        OMFastPMTModel(G4String name, G4Region* envelope, G4bool generate);
+        ~OMFastPMTModel();
+
+        G4bool IsApplicable(const G4ParticleDefinition& particle);
+        G4bool ModelTrigger(const G4FastTrack& fast_track);
+        void   DoIt(const G4FastTrack& fast_track, G4FastStep& fast_step);
+
+    private:
+
+        G4int getBin(const G4FastTrack& fast_track);
+
+        G4bool            _generate;
+        OMPhotocathodeSD* _photocathode_sd;
+};
+
+#endif
\ No newline at end of file
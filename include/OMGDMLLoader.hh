@@ -0,0 +1,39 @@
+#ifndef OM_GDML_LOADER_H
+#define OM_GDML_LOADER_H 1
+
+// system includes
+#include <vector>
+
+// G4 includes
+#include "globals.hh"
+
+// project includes
+
+// forward declarations
+class G4VPhysicalVolume;
+struct OMGDMLVolumeFile;
+
+/*  Loader for the mother + per-volume GDML layout of the imported geometries: a mother file holding the world box
+    and one <physvol><file/></physvol> per part, each part a single tessellated volume. The part files are parsed and
+    their tessellated solids built on a pool of threads; only the registration in the Geant4 stores and the placement
+    happen on the calling thread. Files not following this layout are left to G4GDMLParser. */
+
+class OMGDMLLoader
+{
+    public:
+
+        // constructors
+        OMGDMLLoader(G4int nr_of_threads = 0);   // 0: one thread per core
+        ~OMGDMLLoader();
+
+        // returns nullptr if the file does not follow the supported layout
+        G4VPhysicalVolume* read(const G4String& filename);
+
+    private:
+
+        G4bool readVolumeFile(OMGDMLVolumeFile& file);
+
+        G4int _nr_of_threads;
+};
+
+#endif
\ No newline at end of file
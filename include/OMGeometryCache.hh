@@ -0,0 +1,61 @@
+#ifndef OM_GEOMETRY_CACHE_H
+#define OM_GEOMETRY_CACHE_H 1
+
+// system includes
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// G4 includes
+#include "globals.hh"
+
+// project includes
+
+// forward declarations
+class G4VPhysicalVolume;
+class G4LogicalVolume;
+class G4VSolid;
+
+/*  Binary cache of the geometry read from GDML (analytic solids and tessellated solids incl. all facets, logical volumes with their materials
+    and placements). The cache is keyed by a hash of the GDML file, all files it references and the settings
+    that change the geometry, so a stale cache is never loaded. */
+
+class OMGeometryCache
+{
+    public:
+
+        // constructors
+        OMGeometryCache(G4String directory, G4String gdml_filename, G4String settings);
+        ~OMGeometryCache();
+
+        // returns nullptr if there is no valid cache for the current key
+        G4VPhysicalVolume* load();
+
+        // returns false if the geometry contains solids that can not be cached
+        G4bool save(G4VPhysicalVolume* world);
+
+        G4String getFilename(){return this->_filename;};
+
+    private:
+
+        void writeLogical(G4LogicalVolume* logical);
+        G4int writeSolid(G4VSolid* solid);
+
+        static std::uint64_t hashFile(const G4String& filename, std::uint64_t hash);
+
+        G4String                            _filename;
+        G4String                            _directory;
+        std::uint64_t                       _key;
+
+        // state while saving
+        std::map<G4VSolid*, G4int>          _solid_index;
+        std::map<G4LogicalVolume*, G4int>   _logical_index;
+        std::vector<char>                   _solid_data;
+        std::vector<char>                   _logical_data;
+        std::vector<char>                   _placement_data;
+        G4int                               _nr_of_placements;
+        G4bool                              _save_ok;
+};
+
+#endif
\ No newline at end of file
@@ -6,6 +6,7 @@
 // G4 Includes
 #include "G4Material.hh"
 #include "G4OpticalSurface.hh"
+#include "G4PhysicsFreeVector.hh"
 
 // project includes
 #include "OMDataReader.hh"
@@ -37,6 +38,8 @@ class OMMaterialManager{
         G4OpticalSurface* BuildPhotocathodeSurface();
         G4OpticalSurface* BuildReflectorSurface();
 
+        G4double GetQuantumEfficiency(G4double energy);
+
 
     private:
 
@@ -63,6 +66,8 @@ class OMMaterialManager{
         G4OpticalSurface* _photocathodeSurface;
         G4OpticalSurface* _reflectorSurface;
 
+        G4PhysicsFreeVector* _quantumEfficiency;
+
 };
 
 #endif
\ No newline at end of file
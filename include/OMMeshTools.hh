@@ -0,0 +1,70 @@
+#ifndef OM_MESH_TOOLS_H
+#define OM_MESH_TOOLS_H 1
+
+// system includes
+#include <array>
+#include <functional>
+#include <vector>
+
+// G4 includes
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4Transform3D.hh"
+
+// project includes
+
+// forward declarations
+class G4TessellatedSolid;
+class G4VSolid;
+
+/*  indexed copy of a tessellated solid, used for geometric comparisons of the imported meshes */
+
+struct OMMesh
+{
+    std::vector<G4ThreeVector>        vertices;
+    std::vector<std::array<G4int, 4>> facets;      // vertex indices, [3] = -1 for triangles
+
+    G4ThreeVector                     centroid;
+    G4double                          eigenvalues[3];  // of the vertex covariance, descending
+    G4ThreeVector                     axes[3];         // principal axes, right-handed
+    G4double                          extent;          // largest bounding box edge
+};
+
+class OMMeshTools
+{
+    public:
+
+        static OMMesh getMesh(const G4TessellatedSolid* solid);
+
+        // finds the rigid transform with mesh_b = transform * mesh_a. Vertices have to coincide within
+        // the relative tolerance, facets have to connect the same vertices
+        static G4bool findRigidTransform(const OMMesh& mesh_a, const OMMesh& mesh_b, G4Transform3D& transform, G4double tolerance = 1e-6);
+
+        // edge collapse decimation of a closed mesh, no vertex moves further than max_deviation away from the planes of
+        // the original facets it replaces. Returns nullptr if the mesh is not closed and manifold or can not be reduced
+        static G4TessellatedSolid* decimate(const G4TessellatedSolid* solid, G4double max_deviation);
+
+        // fits a sphere (shell, optionally cut by polar cones), tube, cone or ellipsoid to the mesh. The primitive is
+        // accepted if all vertices and facet centres are within tolerance of its surface and the volumes agree.
+        // placement moves the primitive onto the mesh, returns nullptr if no primitive fits
+        static G4VSolid* fitPrimitive(const G4TessellatedSolid* solid, G4double tolerance, G4Transform3D& placement);
+
+        // least squares sphere through the points, returns the largest distance of a point to its surface or a negative
+        // value if the points do not determine a sphere
+        static G4double fitSphere(const std::vector<G4ThreeVector>& points, G4ThreeVector& centre, G4double& radius);
+
+        // convex hull of a point cloud (quickhull), points closer than 1e-10 of the extent to a hull face count as inside.
+        // Returns nullptr if the points are coplanar
+        static G4TessellatedSolid* convexHull(const G4String& name, const std::vector<G4ThreeVector>& points);
+
+    private:
+
+        static void principalAxes(OMMesh& mesh);
+
+        // largest distance of vertices and facet centres to the surface of a candidate primitive, negative if the
+        // volumes do not agree within tolerance
+        static G4double fitResidual(const OMMesh& mesh, const G4Transform3D& placement, G4double volume, G4double tolerance,
+                                    const std::function<G4double(const G4ThreeVector&)>& distance);
+};
+
+#endif
\ No newline at end of file
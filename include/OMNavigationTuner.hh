@@ -0,0 +1,59 @@
+#ifndef OM_NAVIGATION_TUNER_H
+#define OM_NAVIGATION_TUNER_H 1
+
+// system includes
+#include <vector>
+
+// G4 includes
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+// project includes
+
+// forward declarations
+class G4VPhysicalVolume;
+class G4LogicalVolume;
+class G4TessellatedSolid;
+
+/*  Tunes the navigation voxels of the volumes that dominate the navigation time: the smartless parameter of the mother
+    volumes with many daughters (world, envelope, ...) and the voxel limit of the largest tessellated solids. Every setting
+    is timed by tracing the same set of rays through the module with a G4Navigator, the best settings are written to a
+    text file and applied from it on the next construction. */
+
+class OMNavigationTuner
+{
+    public:
+
+        // constructors
+        OMNavigationTuner(G4VPhysicalVolume* world, G4String filename);
+        ~OMNavigationTuner();
+
+        // coordinate descent over all tuned volumes, nr_of_rays per timing. The result is applied and written to file
+        void   tune(G4int nr_of_rays);
+
+        // returns false if there is no file with settings
+        G4bool apply();
+
+    private:
+
+        // one tuned parameter: smartless of a mother volume or voxel limit of a mesh
+        struct Setting
+        {
+            G4LogicalVolume*    logical;
+            G4TessellatedSolid* tessellated;
+            G4double            value;
+        };
+
+        std::vector<Setting> getSettings();
+        void                 setValue(Setting& setting, G4double value);
+        G4double             benchmark(G4int nr_of_rays);
+        G4bool               write(const std::vector<Setting>& settings);
+
+        G4VPhysicalVolume* _world;
+        G4String           _filename;
+
+        G4ThreeVector      _centre;    // sphere around all daughters of the world, rays start on it
+        G4double           _radius;
+};
+
+#endif
\ No newline at end of file
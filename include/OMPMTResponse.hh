@@ -0,0 +1,103 @@
+#ifndef OM_PMT_RESPONSE_H
+#define OM_PMT_RESPONSE_H 1
+
+// system includes
+#include <cstdint>
+#include <vector>
+
+// G4 includes
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4AffineTransform.hh"
+
+// project includes
+
+/*  Response of a PMT to photons entering its envelope, binned in the entry position (angle to the PMT axis, seen from the
+    centre of the photocathode sphere), the incidence angle on the envelope and the photon energy. Every bin counts entering
+    and detected photons and keeps a random subset of the detections to sample delay and position from.
+    Generated from the detailed PMT model, used by OMFastPMTModel */
+
+struct OMPMTResponseSample
+{
+    float delay;            // ns after entering the envelope
+    float position[3];      // mm, detection point in the PMT frame
+    float angle;            // incidence angle to the photocathode surface normal
+    float weight;           // relative to the weight of the entering photon (QE with QE weighting)
+};
+
+struct OMPMTResponseHeader
+{
+    char     magic[8];          // "OMPMTR1"
+    uint32_t sample_size;       // sizeof(OMPMTResponseSample), guards against layout changes
+    uint32_t qe_weighting;      // generated with QE weighting
+    uint32_t nr_of_bins[3];     // entry position, incidence angle, energy
+    uint32_t samples_per_bin;
+    double   energy_range[2];   // eV
+    double   centre[3];         // mm, centre of the photocathode sphere in the PMT frame
+    double   axis[3];
+};
+
+
+class OMPMTResponse
+{
+    public:
+
+        static OMPMTResponse* getInstance();
+        ~OMPMTResponse();
+
+        // empty table with the default binning around the given photocathode centre and PMT axis (PMT frame)
+        void   reset(const G4ThreeVector& centre, const G4ThreeVector& axis);
+        G4bool read(const G4String& filename);
+        G4bool write(const G4String& filename);
+
+        // bin of a photon entering the envelope, position, direction and surface normal in the PMT frame
+        G4int getBin(const G4ThreeVector& position, const G4ThreeVector& direction, const G4ThreeVector& normal, G4double energy);
+
+        // generation: a photon entered the envelope of a PMT, a detection before the next entry or the end of the track
+        // belongs to this entry
+        void recordEntry(G4int track_id, G4int bin, G4double time, const G4AffineTransform& global_to_local);
+        void recordDetection(G4int track_id, G4double time, const G4ThreeVector& position, G4double angle, G4double weight);
+        void endTrack(){this->_pending_bin = -1;};
+
+        // fast simulation: detection sampled for a photon entering in the given bin, nullptr if it is not detected
+        const OMPMTResponseSample* sample(G4int bin);
+
+        void printSummary();
+
+        // inline from here on
+
+        void     setFilename(G4String val){this->_filename = val;};
+        G4String getFilename(){return this->_filename;};
+
+        void     setMode(G4String val){this->_mode = val;};
+        G4String getMode(){return this->_mode;};
+        G4bool   getGenerate(){return this->_mode == "generate";};
+
+        G4bool   getQEWeighting(){return this->_header.qe_weighting != 0;};
+        void     setQEWeighting(G4bool val){this->_header.qe_weighting = val;};
+
+    private:
+
+        OMPMTResponse();
+        static OMPMTResponse* _instance;
+
+        G4int getNrOfBins(){return this->_header.nr_of_bins[0] * this->_header.nr_of_bins[1] * this->_header.nr_of_bins[2];};
+
+        G4String                         _mode;               // off, generate or fast
+        G4String                         _filename;
+
+        OMPMTResponseHeader              _header;
+        std::vector<uint64_t>            _entries;
+        std::vector<uint64_t>            _detections;
+        std::vector<uint32_t>            _nr_of_samples;
+        std::vector<OMPMTResponseSample> _samples;            // samples_per_bin per bin
+
+        G4int                            _pending_track_id;
+        G4int                            _pending_bin;        // -1 if no entry waits for a detection
+        G4double                         _pending_time;
+        G4AffineTransform                _pending_global_to_local;
+
+        G4long                           _nr_of_empty_lookups; // fast photons in bins without entries, not detected
+};
+
+#endif
\ No newline at end of file
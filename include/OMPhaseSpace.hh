@@ -0,0 +1,93 @@
+#ifndef OM_PHASE_SPACE_H
+#define OM_PHASE_SPACE_H 1
+
+// system includes
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// G4 includes
+
+// project includes
+
+/*  Binary phase space files: photons crossing a sphere around the module, recorded once and replayed for
+    every geometry variation of the module internals. Fixed size records (mm, ns, eV) behind a small header. */
+
+struct OMPhaseSpaceRecord
+{
+    float position[3];
+    float direction[3];
+    float polarisation[3];
+    float energy;
+    float time;
+    float weight;
+};
+
+struct OMPhaseSpaceHeader
+{
+    char     magic[8];          // "OMPHSP1"
+    uint32_t record_size;       // sizeof(OMPhaseSpaceRecord), guards against layout changes
+    uint32_t reserved;
+    uint64_t nr_of_records;
+    double   radius;            // sphere the photons were recorded on
+    double   centre[3];
+};
+
+
+class OMPhaseSpaceWriter
+{
+    public:
+
+        OMPhaseSpaceWriter();
+        ~OMPhaseSpaceWriter();
+
+        bool open(const std::string& filename, double radius, const double centre[3]);
+        void close();
+        void write(const OMPhaseSpaceRecord& record);
+
+        bool     isOpen(){return this->_file.is_open();};
+        uint64_t getNrOfRecords(){return this->_header.nr_of_records;};
+
+    private:
+
+        void flush();
+
+        std::ofstream                   _file;
+        OMPhaseSpaceHeader              _header;
+        std::vector<OMPhaseSpaceRecord> _buffer;
+};
+
+
+class OMPhaseSpaceReader
+{
+    public:
+
+        OMPhaseSpaceReader();
+        ~OMPhaseSpaceReader();
+
+        bool open(const std::string& filename);
+        void close();
+
+        // records are read through a memory map. the block ahead of the requested record is prefetched,
+        // blocks behind it are released, so files larger than the memory can be streamed
+        const OMPhaseSpaceRecord& getRecord(uint64_t index);
+
+        bool                      isOpen(){return this->_map != nullptr;};
+        uint64_t                  getNrOfRecords(){return this->_header.nr_of_records;};
+        const OMPhaseSpaceHeader& getHeader(){return this->_header;};
+
+    private:
+
+        void adviseBlock(uint64_t block, int advice);
+
+        void*                     _map;
+        size_t                    _map_size;
+        OMPhaseSpaceHeader        _header;
+        const OMPhaseSpaceRecord* _records;
+
+        uint64_t                  _block_size;      // in records
+        uint64_t                  _current_block;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef OM_PHOTOCATHODE_HIT_H
+#define OM_PHOTOCATHODE_HIT_H 1
+
+// system includes
+
+// G4 includes
+#include "G4VHit.hh"
+#include "G4THitsCollection.hh"
+#include "G4Allocator.hh"
+#include "G4ThreeVector.hh"
+
+// project includes
+
+/*  A single photon detected on the photocathode of a PMT. Allocated from a pool (G4Allocator) to avoid heap traffic per hit */
+
+class OMPhotocathodeHit : public G4VHit
+{
+    public:
+
+        // water, glass, gel, vacuum
+        static const G4int nr_of_path_materials = 4;
+
+        OMPhotocathodeHit();
+        ~OMPhotocathodeHit();
+
+        inline void* operator new(size_t);
+        inline void  operator delete(void*);
+
+        // inline from here on
+
+        void  setChannel(G4int val){this->_channel = val;};
+        G4int getChannel() const {return this->_channel;};
+
+        void     setTime(G4double val){this->_time = val;};
+        G4double getTime() const {return this->_time;};
+
+        void          setPosition(G4ThreeVector val){this->_position = val;};
+        G4ThreeVector getPosition() const {return this->_position;};
+
+        void          setDirection(G4ThreeVector val){this->_direction = val;};
+        G4ThreeVector getDirection() const {return this->_direction;};
+
+        void     setWavelength(G4double val){this->_wavelength = val;};
+        G4double getWavelength() const {return this->_wavelength;};
+
+        void     setIncidenceAngle(G4double val){this->_incidence_angle = val;};
+        G4double getIncidenceAngle() const {return this->_incidence_angle;};
+
+        void setPathLengths(const G4double* val){for (G4int i = 0; i < nr_of_path_materials; i++) this->_path_lengths[i] = val[i];};
+        const G4double* getPathLengths() const {return this->_path_lengths;};
+
+        void     setWeight(G4double val){this->_weight = val;};
+        G4double getWeight() const {return this->_weight;};
+
+    private:
+
+        G4int         _channel;      // copy nr of the PMT
+        G4double      _time;
+        G4ThreeVector _position;
+        G4ThreeVector _direction;
+        G4double      _wavelength;
+        G4double      _incidence_angle;  // angle to the photocathode surface normal
+        G4double      _weight;
+        G4double      _path_lengths[nr_of_path_materials];
+};
+
+typedef G4THitsCollection<OMPhotocathodeHit> OMPhotocathodeHitsCollection;
+
+extern G4ThreadLocal G4Allocator<OMPhotocathodeHit>* OMPhotocathodeHitAllocator;
+
+inline void* OMPhotocathodeHit::operator new(size_t)
+{
+    if (OMPhotocathodeHitAllocator == nullptr) OMPhotocathodeHitAllocator = new G4Allocator<OMPhotocathodeHit>;
+    return (void*) OMPhotocathodeHitAllocator->MallocSingle();
+}
+
+inline void OMPhotocathodeHit::operator delete(void* hit)
+{
+    OMPhotocathodeHitAllocator->FreeSingle((OMPhotocathodeHit*) hit);
+}
+
+#endif
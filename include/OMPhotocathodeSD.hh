@@ -0,0 +1,43 @@
+#ifndef OM_PHOTOCATHODE_SD_H
+#define OM_PHOTOCATHODE_SD_H 1
+
+// system includes
+
+// G4 includes
+#include "G4VSensitiveDetector.hh"
+#include "G4Step.hh"
+#include "G4HCofThisEvent.hh"
+
+// project includes
+#include "OMPhotocathodeHit.hh"
+
+/*  Sensitive detector attached to the photocathode volumes of the PMTs. Photons absorbed in the photocathode are stored as hits.
+    With QE weighting, every photon entering the photocathode is stored and killed, weighted with the quantum efficiency instead */
+
+class OMPhotocathodeSD : public G4VSensitiveDetector
+{
+    public:
+
+        // channel_depth: touchable depth of the PMT (carrying the channel as copy number) seen from the photocathode
+        OMPhotocathodeSD(G4String name, G4String hits_collection_name, G4bool qe_weighting=false, G4int channel_depth=2);
+        ~OMPhotocathodeSD();
+
+        void   Initialize(G4HCofThisEvent*);
+        G4bool ProcessHits(G4Step*, G4TouchableHistory*);
+
+        // hits that are not the result of a step in the photocathode, e.g. from the fast PMT model
+        void   addHit(OMPhotocathodeHit* hit);
+
+    private:
+
+        G4double getIncidenceAngle(G4StepPoint*);
+
+        G4bool                        _qe_weighting;
+        G4int                         _channel_depth;
+
+        OMPhotocathodeHitsCollection* _hits_collection;
+        G4int                         _hits_collection_id;
+        size_t                        _hits_reserve;       // capacity preallocated for the hits of each event
+};
+
+#endif
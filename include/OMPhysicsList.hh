@@ -0,0 +1,62 @@
+#ifndef OM_PHYSICS_LIST_H
+#define OM_PHYSICS_LIST_H 1
+
+// system includes
+#include <cstdint>
+
+// G4 includes
+#include "globals.hh"
+#include "G4VModularPhysicsList.hh"
+
+// project includes
+#include "OMPhysicsListMessenger.hh"
+
+// forward declarations
+class OMPhysicsListMessenger;
+
+/*  Modular physics list of the simulation, selected with --physics on the command line:
+    optical - optical photon processes only (photon runs, no EM or hadronic tables are built)
+    em      - standard EM and decay physics for the charged particles creating Cherenkov light (muon runs)
+    full    - the FTFP_BERT constructors (default)
+    Optical physics and the fast simulation of the PMTs are part of all variants.
+    With a table cache directory, the physics tables built in the first run are stored in a subdirectory keyed by the
+    physics list, production cuts, materials and optical properties and retrieved instead of built by later jobs. */
+
+class OMPhysicsList: public G4VModularPhysicsList
+{
+    public:
+
+        // constructors
+        OMPhysicsList(G4String variant);
+        ~OMPhysicsList();
+
+        virtual void ConstructParticle();
+
+        // called at /run/initialize after the geometry is built, selects retrieval or storage of the physics tables
+        virtual void SetCuts();
+
+        // stores the tables built in the first run if they were not retrieved from the cache
+        void storeTables();
+
+        static G4bool isVariant(const G4String& variant){return variant == "optical" || variant == "em" || variant == "full";};
+
+        // inline from here on
+
+        G4String getVariant(){return this->_variant;};
+
+        G4String getTableCache(){return this->_table_cache;};
+        void     setTableCache(G4String val){this->_table_cache = val;};
+
+    private:
+
+        std::uint64_t getTableKey();
+
+        OMPhysicsListMessenger* _PhysicsListMessenger;
+
+        G4String                _variant;
+        G4String                _table_cache;
+        G4String                _table_directory;   // keyed subdirectory of the cache
+        G4bool                  _store_tables;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef OM_PHYSICS_LIST_MESSENGER_H
+#define OM_PHYSICS_LIST_MESSENGER_H 1
+
+// system includes
+
+// G4 includes
+#include "G4UImessenger.hh"
+#include "G4UIcmdWithAString.hh"
+
+// project includes
+#include "OMPhysicsList.hh"
+
+// forward declarations
+class OMPhysicsList;
+
+class OMPhysicsListMessenger: public G4UImessenger
+{
+    public:
+
+        // constructors
+        OMPhysicsListMessenger(OMPhysicsList*);
+        ~OMPhysicsListMessenger();
+
+        // member functions
+        virtual void SetNewValue(G4UIcommand*, G4String);
+
+    private:
+
+        // PhysicsList instance
+        OMPhysicsList* _PhysicsList;
+
+        // menu dirs
+        G4UIdirectory* _physicsDir;
+
+        // commands
+        G4UIcmdWithAString*   _tableCacheCmd;
+
+};
+
+#endif
\ No newline at end of file
@@ -2,14 +2,19 @@
 #define OM_PRIMARY_GENERATOR_H 1
 
 // system includes
+#include <cstdint>
 
 // G4 includes
 #include "G4VUserPrimaryGeneratorAction.hh"
 #include "G4GeneralParticleSource.hh"
 
 // project includes
+#include "OMPhaseSpace.hh"
 
+// forward declarations
 class G4Event;
+class OMPrimaryGeneratorMessenger;
+
 class OMPrimaryGenerator : public G4VUserPrimaryGeneratorAction
 {
 public:
@@ -19,9 +24,43 @@ public:
         
         virtual void GeneratePrimaries( G4Event* event );
 
+        void setMode(G4String val){this->_mode = val;};
+
+        void setPhaseSpaceFilename(G4String);
+
+        void setPhotonsPerEvent(G4int val){this->_photons_per_event = val;};
+
+        void setListFilename(G4String);
+
+        void setListPhotonsPerEvent(G4int val){this->_list_photons_per_event = val;};
+
+        void setListEventOffset(G4int val){this->_list_event_offset = val;};
+
     private:
 
+        void generatePhaseSpacePrimaries(G4Event* event);
+        void generateListPrimaries(G4Event* event);
+
+        void addPhoton(G4Event* event, const OMPhaseSpaceRecord& record);
+
         G4GeneralParticleSource *_generalParticleSource;
+
+        OMPrimaryGeneratorMessenger* _PrimaryGeneratorMessenger;
+
+        // gps, phasespace or list
+        G4String            _mode;
+
+        // phase space replay
+        G4String            _phasespace_filename;
+        OMPhaseSpaceReader  _phasespace_reader;
+        std::uint64_t       _phasespace_index;
+        G4int               _photons_per_event;
+
+        // externally generated primary list, event N reads records [N * k, (N + 1) * k)
+        G4String            _list_filename;
+        OMPhaseSpaceReader  _list_reader;
+        G4int               _list_photons_per_event;
+        G4int               _list_event_offset;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef OM_PRIMARY_GENERATOR_MESSENGER_H
+#define OM_PRIMARY_GENERATOR_MESSENGER_H 1
+
+// system includes
+
+// G4 includes
+#include "G4UImessenger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+// project includes
+#include "OMPrimaryGenerator.hh"
+
+// forward declarations
+class OMPrimaryGenerator;
+
+class OMPrimaryGeneratorMessenger: public G4UImessenger
+{
+    public:
+
+        // constructors
+        OMPrimaryGeneratorMessenger(OMPrimaryGenerator*);
+        ~OMPrimaryGeneratorMessenger();
+
+        // member functions
+        virtual void SetNewValue(G4UIcommand*, G4String);
+
+    private:
+
+        // PrimaryGenerator instance
+        OMPrimaryGenerator* _PrimaryGenerator;
+
+        // menu dirs
+        G4UIdirectory* _primaryDir;
+        G4UIdirectory* _phaseSpaceDir;
+        G4UIdirectory* _listDir;
+
+        // commands
+        G4UIcmdWithAString*     _modeCmd;
+        G4UIcmdWithAString*     _phaseSpaceFileCmd;
+        G4UIcmdWithAnInteger*   _phaseSpacePerEventCmd;
+        G4UIcmdWithAString*     _listFileCmd;
+        G4UIcmdWithAnInteger*   _listPerEventCmd;
+        G4UIcmdWithAnInteger*   _listEventOffsetCmd;
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,126 @@
+#ifndef OM_PROFILER_H
+#define OM_PROFILER_H 1
+
+// system includes
+#include <chrono>
+#include <vector>
+
+// G4 includes
+#include "globals.hh"
+
+// project includes
+#include "OMProfilerMessenger.hh"
+
+// forward declarations
+class OMProfilerMessenger;
+class G4Run;
+
+/*  Wall-clock time and memory of the startup phases (construction steps, physics, run initialisation). Phases may
+    nest, the table printed after the first run initialisation indents them by depth, the same numbers can be written
+    to a JSON file to follow startup regressions across geometry versions.
+    During a run, progress reports (events, event/track/step rates, ETA, wall and CPU time, memory) are printed in a
+    configurable wall time interval, the totals of the run are printed and written to a JSON summary at its end. */
+
+class OMProfiler
+{
+    public:
+
+        static OMProfiler* getInstance();
+        ~OMProfiler();
+
+        void startPhase(const G4String& name);
+        void endPhase();
+
+        // prints and writes the phases recorded so far, only once per job
+        void finishStartup();
+
+        // progress of the current run, called by the run and event actions
+        void beginRun(const G4Run* run);
+        void endEvent();
+        void endRun(const G4Run* run);
+
+        // memory of the process in MB
+        static G4double getRSS();
+        static G4double getPeakRSS();
+
+        // wall time since the profiler was created, in s
+        G4double getWallTime();
+
+        // inline from here on
+
+        G4bool   getStartupFinished(){return this->_startup_finished;};
+
+        void     setStartupFile(G4String val){this->_startup_file = val;};
+        G4String getStartupFile(){return this->_startup_file;};
+
+        void     setProgressInterval(G4double val){this->_progress_interval = val;};
+        G4double getProgressInterval(){return this->_progress_interval;};
+
+        void     setRunSummaryFile(G4String val){this->_run_summary_file = val;};
+        G4String getRunSummaryFile(){return this->_run_summary_file;};
+
+        // per volume and process step profile (OMStepProfiler)
+        void     setStepProfiling(G4bool val){this->_step_profiling = val;};
+        G4bool   getStepProfiling(){return this->_step_profiling;};
+
+        void     setTopVolumes(G4int val){this->_top_volumes = val;};
+        G4int    getTopVolumes(){return this->_top_volumes;};
+
+    private:
+
+        OMProfiler();
+        static OMProfiler* _instance;
+
+        struct Phase
+        {
+            G4String name;
+            G4int    depth;
+            G4double start;          // s since creation of the profiler
+            G4double wall;           // s
+            G4double rss_start;      // MB
+            G4double rss_growth;     // MB
+            G4double peak_rss;       // MB, at the end of the phase
+        };
+
+        // rates and times of the current run
+        struct RunMetrics
+        {
+            G4int    events;
+            G4long   tracks;
+            G4long   steps;
+            G4double wall;           // s
+            G4double cpu;            // s, all threads of the process
+            G4double rss;            // MB
+            G4double peak_rss;       // MB
+        };
+
+        void   printStartup();
+        G4bool writeStartup(const G4String& filename);
+
+        RunMetrics getRunMetrics();
+        void       printProgress();
+        G4bool     writeRunSummary(const G4String& filename, G4int run_id, const RunMetrics& metrics);
+
+        static G4double getCPUTime();
+
+        OMProfilerMessenger*                  _ProfilerMessenger;
+
+        std::chrono::steady_clock::time_point _creation;
+        std::vector<Phase>                    _phases;
+        std::vector<size_t>                   _open_phases;   // indices into _phases
+        G4bool                                _startup_finished;
+        G4String                              _startup_file;
+
+        G4double                              _progress_interval;   // s, 0 disables the reports
+        G4String                              _run_summary_file;
+        G4int                                 _events_to_process;
+        G4int                                 _events_done;
+        G4double                              _run_start;           // wall time
+        G4double                              _run_cpu_start;
+        G4double                              _last_report;         // wall time
+
+        G4bool                                _step_profiling;
+        G4int                                 _top_volumes;
+};
+
+#endif
\ No newline at end of file
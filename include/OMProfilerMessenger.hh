@@ -0,0 +1,47 @@
+#ifndef OM_PROFILER_MESSENGER_H
+#define OM_PROFILER_MESSENGER_H 1
+
+// system includes
+
+// G4 includes
+#include "G4UImessenger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+// project includes
+#include "OMProfiler.hh"
+
+// forward declarations
+class OMProfiler;
+
+class OMProfilerMessenger: public G4UImessenger
+{
+    public:
+
+        // constructors
+        OMProfilerMessenger(OMProfiler*);
+        ~OMProfilerMessenger();
+
+        // member functions
+        virtual void SetNewValue(G4UIcommand*, G4String);
+
+    private:
+
+        // Profiler instance
+        OMProfiler* _Profiler;
+
+        // menu dirs
+        G4UIdirectory* _profileDir;
+
+        // commands
+        G4UIcmdWithAString*          _startupFileCmd;
+        G4UIcmdWithADoubleAndUnit*   _progressIntervalCmd;
+        G4UIcmdWithAString*          _runSummaryFileCmd;
+        G4UIcmdWithABool*            _stepProfilingCmd;
+        G4UIcmdWithAnInteger*        _topVolumesCmd;
+
+};
+
+#endif
\ No newline at end of file
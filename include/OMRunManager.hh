@@ -0,0 +1,26 @@
+#ifndef OM_RUN_MANAGER_H
+#define OM_RUN_MANAGER_H 1
+
+// system includes
+
+// G4 includes
+#include "G4RunManager.hh"
+
+// project includes
+
+/*  Run manager recording the initialisation steps in the OMProfiler: detector construction, physics list and the
+    first run initialisation, in which Geant4 builds the physics tables and the navigation voxels */
+
+class OMRunManager : public G4RunManager
+{
+    public:
+
+        OMRunManager();
+        ~OMRunManager();
+
+        virtual void InitializeGeometry();
+        virtual void InitializePhysics();
+        virtual void RunInitialization();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef OM_STEP_PROFILER_H
+#define OM_STEP_PROFILER_H 1
+
+// system includes
+#include <chrono>
+#include <unordered_map>
+
+// G4 includes
+#include "globals.hh"
+
+// project includes
+
+// forward declarations
+class G4Step;
+class G4VPhysicalVolume;
+class G4VProcess;
+
+/*  Steps, boundary crossings and wall time per physical volume and per process, enabled with /profile/steps. The
+    time between two steps of a track is assigned to the volume (pre step point) and process of the second one. One
+    instance per thread, the counters are reset at the beginning and reported at the end of each run. */
+
+class OMStepProfiler
+{
+    public:
+
+        static OMStepProfiler* getInstance();
+        ~OMStepProfiler();
+
+        void beginRun();
+        void beginTrack(){this->_last_step = std::chrono::steady_clock::now();};
+        void step(const G4Step* step);
+
+        // top_n volumes by time, all processes
+        void report(G4int top_n);
+
+    private:
+
+        OMStepProfiler();
+        static G4ThreadLocal OMStepProfiler* _instance;
+
+        struct Counters
+        {
+            G4long   steps;
+            G4long   boundaries;   // steps limited by a volume boundary
+            G4double time;         // s
+        };
+
+        std::unordered_map<const G4VPhysicalVolume*, Counters> _volumes;
+        std::unordered_map<const G4VProcess*, Counters>        _processes;
+
+        // most steps stay in the volume of the previous one
+        const G4VPhysicalVolume*                               _last_volume;
+        Counters*                                              _last_volume_counters;
+
+        std::chrono::steady_clock::time_point                  _last_step;
+};
+
+#endif
\ No newline at end of file
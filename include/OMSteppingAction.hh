@@ -20,5 +20,9 @@ class OMSteppingAction : public G4UserSteppingAction
 
         void UserSteppingAction(const G4Step*);
 
+    private:
+
+        void recordPhaseSpace(const G4Step*);
+
 };
 #endif
\ No newline at end of file
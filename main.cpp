@@ -2,44 +2,70 @@
 
 // system includes
 #include <iostream>
+#include <vector>
 
 // G4 includes
-#include "G4RunManager.hh"
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
 #include "G4UImanager.hh"
-#include "FTFP_BERT.hh"
-#include "G4OpticalPhysics.hh"
 
 // project includes
 #include "OMConstruction.hh"
 #include "OMPrimaryGenerator.hh"
 #include "OMSteppingAction.hh"
 #include "OMTrackingAction.hh"
+#include "OMEventAction.hh"
 #include "OMRunAction.hh"
 #include "OMDataManager.hh"
+#include "OMPhysicsList.hh"
+#include "OMRunManager.hh"
+#include "OMProfiler.hh"
 
 
 int main(int argc,char** argv)
 {
-    G4RunManager* runManager = new G4RunManager;
+    // the startup profile is measured from here
+    OMProfiler* profiler = OMProfiler::getInstance();
 
-    // set up optical physics
-    G4VModularPhysicsList* OMphysicsList = new FTFP_BERT;
-    G4OpticalPhysics* OMopticalPhysics   = new G4OpticalPhysics();
-    OMphysicsList->RegisterPhysics(OMopticalPhysics);
+    // '--physics <optical/em/full>' may be given anywhere, the remaining arguments select the mode
+    G4String physics = "full";
+    std::vector<char*> args;
+    for (G4int i = 0; i < argc; i++)
+    {
+        if (argv[i] == std::string("--physics") && i + 1 < argc) physics = argv[++i];
+        else args.push_back(argv[i]);
+    }
+    argc = args.size();
+    args.push_back(nullptr);
+    argv = args.data();
+
+    if (!OMPhysicsList::isVariant(physics))
+    {
+        G4Exception("int main()",
+                    "invalid command arguments",
+                    FatalErrorInArgument,
+                    ("Unknown physics list '" + physics + "'.\nTry '--physics optical' for photon runs, '--physics em' for muon runs without hadronic physics or '--physics full' (default) for FTFP_BERT!").c_str());
+    }
+
+    profiler->startPhase("run manager setup");
+    OMRunManager* runManager = new OMRunManager;
+
+    // FTFP_BERT with optical physics unless a lean list is requested
+    OMPhysicsList* OMphysicsList = new OMPhysicsList(physics);
 
     // run manager initialisation
     runManager->SetUserInitialization(OMphysicsList);
     runManager->SetUserInitialization(new OMConstruction());
     runManager->SetUserAction        (new OMPrimaryGenerator());
     runManager->SetUserAction        (new OMRunAction());
+    runManager->SetUserAction        (new OMEventAction());
     runManager->SetUserAction        (new OMTrackingAction());
     runManager->SetUserAction        (new OMSteppingAction());
     //runManager->Initialize(); // done in macro
 
     // call singletons where necessary
     OMDataManager::getInstance();
+    profiler->endPhase();
 
     // set random engine
     CLHEP::HepRandom::setTheEngine(new CLHEP::MTwistEngine);
@@ -63,15 +89,18 @@ int main(int argc,char** argv)
     }
     else if ( argv[1] == std::string("--batch") )
     {
+        // optional macro replacing init.mac, e.g. for benchmarks
+        G4String macro = argc > 2 ? argv[2] : "macros/init.mac";
+
         G4UImanager* UImanager = G4UImanager::GetUIpointer();
-        UImanager->ApplyCommand("/control/execute macros/init.mac");
+        UImanager->ApplyCommand("/control/execute " + macro);
     }
     else
     {
         G4Exception("int main()",
                     "invalid command arguments",
                     FatalErrorInArgument,
-                    "Can't make sense of command line arguments.\nTry '--batch' for batch mode or '--vis' for interactive mode!");
+                    "Can't make sense of command line arguments.\nTry '--batch [macro]' for batch mode or '--vis' for interactive mode, optionally with '--physics <optical/em/full>'!");
     }
 
     delete runManager;
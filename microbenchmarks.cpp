@@ -0,0 +1,400 @@
+// system includes
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+// G4 includes
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+
+// project includes
+#include "OMDataManager.hh"
+#include "OMDataReader.hh"
+#include "OMPhotocathodeHit.hh"
+
+/*  Microbenchmarks of the per track data path of OMDataManager and of the configuration reader, without Geant4 transport.
+    Every benchmark processes a given number of synthetic records; the harness doubles that number until the minimum time
+    is reached and reports ns per record. Run from the build directory:
+    ./om_microbenchmarks [--benchmark_filter <regex>] [--benchmark_min_time <s>] [--output_directory <dir>]
+    Without an output directory the records are written to /dev/null, so only the formatting is measured. */
+
+
+//-----------
+// harness
+//-----------
+
+struct Benchmark
+{
+    std::string                 name;
+    std::string                 unit;         // what one record is
+    std::function<void(G4long)> function;     // processes the given number of records
+};
+
+static std::vector<Benchmark>& getBenchmarks()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+static void registerBenchmark(std::string name, std::string unit, std::function<void(G4long)> function)
+{
+    getBenchmarks().push_back({name, unit, function});
+}
+
+static G4double runBenchmark(const Benchmark& benchmark, G4double min_time, G4long& nr_of_records)
+{
+    // warm up once, then double the number of records until the run is long enough to be timed reliably
+    benchmark.function(1);
+
+    G4double elapsed = 0;
+    for (nr_of_records = 1; ; nr_of_records *= 2)
+    {
+        auto start = std::chrono::steady_clock::now();
+        benchmark.function(nr_of_records);
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed >= min_time || nr_of_records >= (G4long(1) << 40)) break;
+    }
+    return elapsed;
+}
+
+
+//-----------
+// synthetic input
+//-----------
+
+struct SyntheticTrack
+{
+    G4int         pid;
+    G4double      in_time;
+    G4ThreeVector in_position;
+    G4double      in_energy;
+    G4ThreeVector in_momentum;
+    G4bool        glass_contact;
+    G4ThreeVector glass_position;
+    G4ThreeVector glass_direction;
+    G4double      out_time;
+    G4ThreeVector out_position;
+    G4double      out_energy;
+    G4ThreeVector out_momentum;
+    G4String      out_volume_name;
+    G4int         out_volume_copyno;
+    G4String      out_process_name;
+};
+
+static const size_t nr_of_synthetic_tracks = 4096;
+static const G4int  hits_per_event         = 64;
+static const G4int  tracks_per_event       = 128;
+
+// photons from a sphere around the module, half of them touch the glass, the names as written by the stepping action
+static std::vector<SyntheticTrack> makeTracks()
+{
+    std::mt19937                           generator(4711);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::normal_distribution<double>       normal;
+    auto randomDirection = [&](){return G4ThreeVector(normal(generator), normal(generator), normal(generator)).unit();};
+
+    const std::vector<G4String> volumes   = {"World", "photocathode", "glass", "gel", "PMT_envelope"};
+    const std::vector<G4String> processes = {"OpAbsorption", "Transportation", "OpWLS"};
+
+    std::vector<SyntheticTrack> tracks(nr_of_synthetic_tracks);
+    for (SyntheticTrack& track : tracks)
+    {
+        track.pid               = -22;
+        track.in_time           = 0;
+        track.in_position       = 300 * mm * randomDirection();
+        track.in_energy         = (1.5 + 3 * uniform(generator)) * eV;
+        track.in_momentum       = track.in_energy * randomDirection();
+        track.glass_contact     = uniform(generator) < 0.5;
+        track.glass_position    = 200 * mm * randomDirection();
+        track.glass_direction   = randomDirection();
+        track.out_time          = 10 * ns * uniform(generator);
+        track.out_position      = 150 * mm * randomDirection();
+        track.out_energy        = track.in_energy;
+        track.out_momentum      = track.out_energy * randomDirection();
+        track.out_volume_name   = volumes[generator() % volumes.size()];
+        track.out_volume_copyno = generator() % 16;
+        track.out_process_name  = processes[generator() % processes.size()];
+    }
+    return tracks;
+}
+
+static const std::vector<SyntheticTrack>& getTracks()
+{
+    static std::vector<SyntheticTrack> tracks = makeTracks();
+    return tracks;
+}
+
+// the full sequence of calls the tracking and stepping actions make for one track
+static void handoverTrack(OMDataManager* data, const SyntheticTrack& track)
+{
+    data->reset();
+    data->beginTrack();
+    data->preTrackHandover(track.pid, track.in_time, track.in_position, track.in_energy, track.in_momentum);
+    if (track.glass_contact) data->glassContactHandover(track.glass_position, track.glass_direction);
+    data->postTrackHandover(track.out_time, track.out_position, track.out_energy, track.out_momentum,
+                            track.out_volume_name, track.out_volume_copyno, track.out_process_name);
+    data->write();
+}
+
+// configuration of the data manager for one benchmark, everything else at its defaults
+struct DataSettings
+{
+    G4String output_mode   = "tracks";
+    G4bool   path_lengths  = false;
+    G4bool   glass_filter  = false;
+    G4bool   trigger       = false;
+    G4bool   phase_space   = false;
+};
+
+static G4String output_directory = "";
+
+static G4String outputFile(const G4String& name)
+{
+    return output_directory == "" ? G4String("/dev/null") : G4String(output_directory + "/" + name);
+}
+
+static void configure(OMDataManager* data, const G4String& name, const DataSettings& settings)
+{
+    // the previous output of the same benchmark is replaced without the warning of setFilename
+    if (output_directory != "") std::filesystem::remove(std::string(outputFile(name + ".csv")));
+    data->setFilename(outputFile(name + ".csv"));
+    data->setOutputMode(settings.output_mode);
+    data->setRecordPathLengths(settings.path_lengths);
+    data->setDataGlassFilter(settings.glass_filter);
+    data->setPhotonsFilter(false);
+    data->setDataOutProcessFilter("");
+    data->setDataOutVolumeFilter("");
+    data->setTriggerEnabled(settings.trigger);
+    data->setTriggerMultiplicity(2);
+    data->setTriggerWindow(20 * ns);
+    data->setPhaseSpaceFilename(settings.phase_space ? outputFile(name + ".phsp") : G4String(""));
+    data->setPhaseSpaceRadius(300 * mm);
+}
+
+// one track record per synthetic track, events of tracks_per_event tracks
+static void registerTrackBenchmark(const G4String& name, const DataSettings& settings)
+{
+    registerBenchmark("data/" + name, "record", [name, settings](G4long nr_of_records)
+    {
+        OMDataManager* data = OMDataManager::getInstance();
+        configure(data, name, settings);
+        data->open();
+
+        const std::vector<SyntheticTrack>& tracks = getTracks();
+        data->beginEvent();
+        for (G4long i = 0; i < nr_of_records; i++)
+        {
+            handoverTrack(data, tracks[i % tracks.size()]);
+            if ((i + 1) % tracks_per_event == 0)
+            {
+                data->endEvent(G4int(i / tracks_per_event), nullptr);
+                data->beginEvent();
+            }
+        }
+        data->endEvent(G4int(nr_of_records / tracks_per_event), nullptr);
+        data->close();
+    });
+}
+
+
+//-----------
+// data path
+//-----------
+
+static void registerDataBenchmarks()
+{
+    DataSettings tracks;
+    registerTrackBenchmark("tracks", tracks);
+
+    DataSettings path_lengths;
+    path_lengths.path_lengths = true;
+    registerTrackBenchmark("tracks_path_lengths", path_lengths);
+
+    // about half of the records are dropped by the filter
+    DataSettings glass_filter;
+    glass_filter.glass_filter = true;
+    registerTrackBenchmark("tracks_glass_filter", glass_filter);
+
+    // records go to the event buffer, events without a trigger are discarded
+    DataSettings trigger;
+    trigger.trigger = true;
+    registerTrackBenchmark("tracks_trigger_buffer", trigger);
+
+    // filters and handover without any output
+    registerBenchmark("data/handover_only", "record", [](G4long nr_of_records)
+    {
+        OMDataManager*                     data   = OMDataManager::getInstance();
+        const std::vector<SyntheticTrack>& tracks = getTracks();
+        G4long                             nr_of_passed = 0;
+        for (G4long i = 0; i < nr_of_records; i++)
+        {
+            const SyntheticTrack& track = tracks[i % tracks.size()];
+            data->reset();
+            data->preTrackHandover(track.pid, track.in_time, track.in_position, track.in_energy, track.in_momentum);
+            if (track.glass_contact) data->glassContactHandover(track.glass_position, track.glass_direction);
+            data->postTrackHandover(track.out_time, track.out_position, track.out_energy, track.out_momentum,
+                                    track.out_volume_name, track.out_volume_copyno, track.out_process_name);
+            if (!data->doFiltersApply()) nr_of_passed++;
+        }
+        volatile G4long sink = nr_of_passed;
+        (void) sink;
+    });
+
+    // one record per photocathode hit, written at the end of the event. Whole events of hits_per_event hits are written,
+    // so the number of records is rounded up to a multiple of 64; the rounding is negligible for the counts that are timed
+    registerBenchmark("data/hits", "hit", [](G4long nr_of_records)
+    {
+        OMDataManager* data = OMDataManager::getInstance();
+        DataSettings   settings;
+        settings.output_mode = "hits";
+        configure(data, "hits", settings);
+        data->open();
+
+        const std::vector<SyntheticTrack>& tracks = getTracks();
+        OMPhotocathodeHitsCollection* hits = new OMPhotocathodeHitsCollection("microbenchmark", "hits");
+        for (G4int i = 0; i < hits_per_event; i++)
+        {
+            const SyntheticTrack& track = tracks[i];
+            OMPhotocathodeHit*    hit   = new OMPhotocathodeHit();
+            hit->setChannel(track.out_volume_copyno);
+            hit->setTime(track.out_time);
+            hit->setPosition(track.out_position);
+            hit->setDirection(track.out_momentum.unit());
+            hit->setWavelength(1239.84 / (track.out_energy / eV));
+            hit->setIncidenceAngle(0.5);
+            hit->setWeight(1);
+            hits->insert(hit);
+        }
+
+        for (G4long event = 0; event * hits_per_event < nr_of_records; event++)
+        {
+            data->beginEvent();
+            data->endEvent(G4int(event), hits);
+        }
+        data->close();
+        delete hits;
+    });
+
+    // phase space records only, no track records are written
+    registerBenchmark("data/phase_space", "record", [](G4long nr_of_records)
+    {
+        OMDataManager* data = OMDataManager::getInstance();
+        DataSettings   settings;
+        settings.phase_space = true;
+        configure(data, "phase_space", settings);
+        data->open();
+
+        const std::vector<SyntheticTrack>& tracks = getTracks();
+        for (G4long i = 0; i < nr_of_records; i++)
+        {
+            const SyntheticTrack& track = tracks[i % tracks.size()];
+            data->beginTrack();
+            if (data->getRecordPhaseSpace())
+            {
+                data->phaseSpaceHandover(track.in_position, track.in_momentum.unit(), track.glass_direction, track.in_energy, track.in_time, 1);
+            }
+        }
+        data->close();
+    });
+}
+
+
+//-----------
+// configuration reader
+//-----------
+
+static G4String writeSyntheticConfiguration(G4int nr_of_arrays, G4int array_length, G4int nr_of_scalars)
+{
+    G4String filename = (std::filesystem::temp_directory_path() / ("om_microbenchmark_" + std::to_string(nr_of_arrays) + "x" + std::to_string(array_length) + ".cfg")).string();
+
+    std::mt19937                           generator(1913);
+    std::uniform_real_distribution<double> uniform(0, 100);
+
+    std::ofstream file(filename);
+    file << "# synthetic configuration for om_microbenchmarks\n";
+    for (G4int i = 0; i < nr_of_arrays; i++)
+    {
+        file << "ARRAY array" << i;
+        for (G4int j = 0; j < array_length; j++) file << " " << uniform(generator);
+        file << "   # comment\n";
+    }
+    for (G4int i = 0; i < nr_of_scalars; i++) file << "scalar" << i << "    " << uniform(generator) << "\n";
+    file << "STR name synthetic\n";
+    return filename;
+}
+
+static void registerReaderBenchmark(const G4String& name, const G4String& filename)
+{
+    registerBenchmark("reader/" + name, "parse", [filename](G4long nr_of_records)
+    {
+        G4double sum = 0;
+        for (G4long i = 0; i < nr_of_records; i++)
+        {
+            OMDataReader reader(filename.c_str());
+            sum += reader.GetScalarNames().size() + reader.GetArrayNames().size();
+        }
+        volatile G4double sink = sum;
+        (void) sink;
+    });
+}
+
+static void registerReaderBenchmarks()
+{
+    // the configuration shipped with the simulation, copied into the build directory by cmake
+    static const G4String optical_properties = "macros/optical_properties.cfg";
+    if (std::filesystem::exists(std::string(optical_properties))) registerReaderBenchmark("optical_properties", optical_properties);
+    else std::cerr << optical_properties << " not found, run from the build directory to benchmark it" << std::endl;
+
+    registerReaderBenchmark("synthetic_small", writeSyntheticConfiguration(20,   10,  20));
+    registerReaderBenchmark("synthetic_large", writeSyntheticConfiguration(200, 100, 200));
+}
+
+
+int main(int argc, char** argv)
+{
+    std::string filter   = ".*";
+    G4double    min_time = 0.5;   // s
+    for (G4int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string option = argv[i];
+        if      (option == "--benchmark_filter")   filter           = argv[i + 1];
+        else if (option == "--benchmark_min_time") min_time         = std::stod(argv[i + 1]);
+        else if (option == "--output_directory")   output_directory = argv[i + 1];
+        else
+        {
+            std::cerr << "unknown option " << option << ", options: --benchmark_filter <regex> --benchmark_min_time <s> --output_directory <dir>" << std::endl;
+            return 1;
+        }
+    }
+    if (output_directory != "") std::filesystem::create_directories(std::string(output_directory));
+
+    registerDataBenchmarks();
+    registerReaderBenchmarks();
+
+    std::cout << std::left  << std::setw(36) << "benchmark"
+              << std::right << std::setw(14) << "records" << std::setw(14) << "time [s]" << std::setw(14) << "ns" << std::setw(16) << "per second" << std::endl;
+
+    const std::regex selection(filter);
+    for (const Benchmark& benchmark : getBenchmarks())
+    {
+        if (!std::regex_search(benchmark.name, selection)) continue;
+
+        G4long   nr_of_records = 0;
+        G4double elapsed       = runBenchmark(benchmark, min_time, nr_of_records);
+
+        std::cout << std::left  << std::setw(36) << benchmark.name
+                  << std::right << std::setw(14) << nr_of_records
+                  << std::setw(14) << std::fixed << std::setprecision(3) << elapsed
+                  << std::setw(14) << std::setprecision(1) << 1e9 * elapsed / nr_of_records
+                  << std::setw(16) << std::scientific << std::setprecision(3) << nr_of_records / elapsed
+                  << " " << benchmark.unit << "s" << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -1,11 +1,16 @@
 // system includes
 #include <cmath>
+#include <map>
+#include <memory>
+#include <set>
 
 // G4 includes
 #include "G4NistManager.hh"
 #include "G4GDMLParser.hh"
 #include "G4VSolid.hh"
 #include "G4Box.hh"
+#include "G4Orb.hh"
+#include "G4Tubs.hh"
 #include "G4Cons.hh"
 #include "G4Sphere.hh"
 #include "G4Ellipsoid.hh"
@@ -13,6 +18,7 @@
 #include "G4IntersectionSolid.hh"
 #include "G4SubtractionSolid.hh"
 #include "G4UnionSolid.hh"
+#include "G4DisplacedSolid.hh"
 #include "G4LogicalVolume.hh"
 #include "G4PVPlacement.hh"
 #include "G4SystemOfUnits.hh"
@@ -20,25 +26,56 @@
 #include "G4VisAttributes.hh"
 #include "G4LogicalSkinSurface.hh"
 #include "G4LogicalBorderSurface.hh"
+#include "G4SDManager.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4Polyhedron.hh"
+#include "G4Region.hh"
 
 // project includes
 #include "OMConstruction.hh"
+#include "OMPhotocathodeSD.hh"
+#include "OMGeometryCache.hh"
+#include "OMGDMLLoader.hh"
+#include "OMMeshTools.hh"
+#include "OMPMTResponse.hh"
+#include "OMFastPMTModel.hh"
+#include "OMNavigationTuner.hh"
+#include "OMProfiler.hh"
 
 
 OMConstruction::OMConstruction()
 : G4VUserDetectorConstruction(),
  _submerge(false),
+ _submerge_mode("boolean"),
+ _envelope(true),
  _solidReflector(false),
+ _qe_weighting(false),
+ _flatten_pmt(false),
+ _fast_pmt_mode("off"),
+ _pmt_response_file(""),
+ _photocathode_centre(0,0,0),
+ _navigation_file(""),
+ _navigation_tuning(false),
+ _navigation_rays(20000),
  _world_phsical(nullptr),
  _world_logical(nullptr),
+ _module_physical(nullptr),
+ _module_logical(nullptr),
+ _interior_physical(nullptr),
  _gelpad_solid(nullptr),
  _pmt_logical(nullptr),
  _nr_of_OUs(0),
  _gdml_filename(""),
+ _gdml_cache_directory(""),
+ _gdml_threads(0),
+ _deduplicate(true),
+ _decimation_tolerance(0),
+ _primitive_tolerance(0),
  _ou_coord_center(0,0,0),
  _ou_coord_refX(1,0,0),
  _ou_coord_refY(0,1,0),
  _gelpad_ring_offset(0),
+ _gelpad_tolerance(0),
  _photocathode_tube_length(0)
 {
     this->_MaterialManager       = OMMaterialManager::getInstance();
@@ -53,10 +90,13 @@ OMConstruction::~OMConstruction()
     delete this->_world_phsical;
     delete this->_gelpad_solid;
     delete this->_pmt_logical;
+    for (G4RotationMatrix* rotation : this->_placement_rotations) delete rotation;
 }
 
 G4VPhysicalVolume* OMConstruction::Construct()
 {
+    OMProfiler* profiler = OMProfiler::getInstance();
+
     //------------
     // read world from GDML or give empty world
     //------------
@@ -69,25 +109,44 @@ G4VPhysicalVolume* OMConstruction::Construct()
     }
     else
     {
-        G4GDMLParser parser;
-        parser.SetOverlapCheck(false);
-        parser.Read(_gdml_filename);
-        this->_world_phsical = parser.GetWorldVolume();
-        this->_world_logical = this->_world_phsical->GetLogicalVolume();
-        this->configureGDMLObjects();
+        profiler->startPhase("GDML import");
+        this->readGDML();
+        profiler->endPhase();
     }
 
     //------------
-    // submerge P-OM if needed
+    // place optical units (gelpad and pmt)
     //------------
 
-    if (this->_submerge) this->submerge();
+    profiler->startPhase("placeOpticalUnits");
+    this->placeOpticalUnits();
+    profiler->endPhase();
 
     //------------
-    // place optical units (gelpad and pmt)
+    // wrap the module in a simple envelope, the world navigator then only sees one daughter
     //------------
 
-    this->placeOpticalUnits();
+    this->_module_physical = this->_world_phsical;
+    this->_module_logical  = this->_world_logical;
+    if (this->_envelope)
+    {
+        profiler->startPhase("createEnvelope");
+        this->createEnvelope();
+        profiler->endPhase();
+    }
+
+    //------------
+    // submerge P-OM if needed
+    //------------
+
+    if (this->_submerge)
+    {
+        profiler->startPhase("submerge");
+        this->submerge();
+        profiler->endPhase();
+    }
+
+    if (this->getSolidReflector()) this->placeSolidReflectors();
 
     //------------
     // setup and return world
@@ -96,10 +155,164 @@ G4VPhysicalVolume* OMConstruction::Construct()
     G4VisAttributes* world_vis = new G4VisAttributes(false);  // visibility = false
     this->_world_logical->SetVisAttributes(world_vis);
 
+    //------------
+    // tune the navigation voxels or apply the tuned settings
+    //------------
+
+    if (this->_navigation_file != "")
+    {
+        profiler->startPhase(this->_navigation_tuning ? "navigation tuning" : "navigation settings");
+        OMNavigationTuner tuner(this->_world_phsical, this->_navigation_file);
+        if (this->_navigation_tuning)
+        {
+            tuner.tune(this->_navigation_rays);
+        }
+        else if (!tuner.apply())
+        {
+            G4Exception("OMConstruction::Construct()",
+                        "no navigation settings",
+                        JustWarning,
+                        ("The navigation settings " + this->_navigation_file + " could not be read, the Geant4 defaults are used. Create them with /geometry/navigation/tune true").c_str());
+        }
+        profiler->endPhase();
+    }
+
     return this->_world_phsical;
 }
 
-void OMConstruction::configureGDMLObjects()
+void OMConstruction::ConstructSDandField()
+{
+    // no PMTs, no photocathode
+    if (this->_photocathode_logicals.empty()) return;
+
+    // photocathode -> vacuum part -> PMT, or photocathode -> PMT if flattened
+    OMPhotocathodeSD* photocathodeSD = new OMPhotocathodeSD("photocathodeSD", "photocathodeHits", this->_qe_weighting, this->_flatten_pmt ? 1 : 2);
+    G4SDManager::GetSDMpointer()->AddNewDetector(photocathodeSD);
+
+    for (G4LogicalVolume* photocathode_logical : this->_photocathode_logicals)
+    {
+        this->SetSensitiveDetector(photocathode_logical, photocathodeSD);
+    }
+
+    //-----------
+    // fast PMT model on the PMT envelope
+    //-----------
+
+    if (this->_fast_pmt_mode == "off") return;
+
+    OMPMTResponse* response = OMPMTResponse::getInstance();
+    response->setMode(this->_fast_pmt_mode);
+    response->setFilename(this->_pmt_response_file);
+
+    if (this->_fast_pmt_mode == "generate")
+    {
+        // the axis of the PMT is the y axis of its frame (see constructPMT())
+        response->reset(this->_photocathode_centre, G4ThreeVector(0,1,0));
+        response->setQEWeighting(this->_qe_weighting);
+    }
+    else if (!response->read(this->_pmt_response_file))
+    {
+        G4Exception("OMConstruction::ConstructSDandField()",
+                    "can not read PMT response table",
+                    FatalException,
+                    ("The fast PMT model needs a response table, " + this->_pmt_response_file + " could not be read. Generate one with /geometry/PMT/fastModel generate").c_str());
+    }
+    else if (response->getQEWeighting() != this->_qe_weighting)
+    {
+        G4Exception("OMConstruction::ConstructSDandField()",
+                    "QE weighting of PMT response table differs",
+                    JustWarning,
+                    "The PMT response table was generated with a different QE weighting setting, the hit weights follow the table.");
+    }
+
+    G4Region* pmt_region = new G4Region("PMT");
+    pmt_region->AddRootLogicalVolume(this->_pmt_logical);
+    new OMFastPMTModel("fastPMT", pmt_region, this->_fast_pmt_mode == "generate");
+}
+
+void OMConstruction::readGDML()
+{
+    //-----------
+    // try binary cache first, parsing the tessellated GDML files takes long
+    //-----------
+
+    OMProfiler* profiler = OMProfiler::getInstance();
+
+    // the cache key hashes all GDML files, so it is only computed if a cache is used
+    std::unique_ptr<OMGeometryCache> cache;
+
+    if (this->_gdml_cache_directory != "")
+    {
+        profiler->startPhase("geometry cache");
+
+        // settings changing the imported geometry are part of the cache key
+        G4String cache_settings = "deduplicate=" + std::to_string(this->_deduplicate) + ";decimation=" + std::to_string(this->_decimation_tolerance / mm)
+                                + ";primitives=" + std::to_string(this->_primitive_tolerance / mm);
+        cache.reset(new OMGeometryCache(this->_gdml_cache_directory, this->_gdml_filename, cache_settings));
+        this->_world_phsical = cache->load();
+        profiler->endPhase();
+
+        if (this->_world_phsical != nullptr)
+        {
+            G4cout << ">> geometry read from cache " << cache->getFilename() << G4endl;
+            this->_world_logical = this->_world_phsical->GetLogicalVolume();
+
+            profiler->startPhase("configureGDMLObjects");
+            this->configureGDMLObjects();
+            profiler->endPhase();
+            return;
+        }
+    }
+
+    //-----------
+    // parse GDML, per-volume files in parallel if the layout allows
+    //-----------
+
+    profiler->startPhase("GDML parsing");
+    OMGDMLLoader loader(this->_gdml_threads);
+    this->_world_phsical = loader.read(this->_gdml_filename);
+
+    if (this->_world_phsical == nullptr)
+    {
+        G4GDMLParser parser;
+        parser.SetOverlapCheck(false);
+        parser.Read(_gdml_filename);
+        this->_world_phsical = parser.GetWorldVolume();
+    }
+    profiler->endPhase();
+
+    this->_world_logical = this->_world_phsical->GetLogicalVolume();
+
+    profiler->startPhase("mesh processing");
+    if (this->_deduplicate) this->deduplicateGDMLObjects();
+    if (this->_primitive_tolerance > 0)  this->fitGDMLPrimitives();
+    if (this->_decimation_tolerance > 0) this->decimateGDMLObjects();
+    profiler->endPhase();
+
+    profiler->startPhase("configureGDMLObjects");
+    this->configureGDMLObjects();
+    profiler->endPhase();
+
+    //-----------
+    // write cache for the next run
+    //-----------
+
+    if (cache)
+    {
+        profiler->startPhase("geometry cache");
+        if (cache->save(this->_world_phsical)) G4cout << ">> geometry written to cache " << cache->getFilename() << G4endl;
+        else
+        {
+            G4Exception("OMConstruction::readGDML()",
+                        "can not write geometry cache",
+                        JustWarning,
+                        ("the geometry cache " + cache->getFilename() + " could not be written.").c_str());
+        }
+        profiler->endPhase();
+    }
+}
+
+OMConstruction::GDMLObjectProperties OMConstruction::getGDMLObjectProperties(const G4String& obj_name)
 {
     //-----------
     // construct materials
@@ -115,191 +328,368 @@ void OMConstruction::configureGDMLObjects()
     G4OpticalSurface* plasticSurface  = this->_MaterialManager->BuildPlasticSurface();
     G4OpticalSurface* titaniumSurface = this->_MaterialManager->BuildTitaniumSurface();
 
+    //-----------
+    // properties depending on name
+    //-----------
+
+    GDMLObjectProperties properties;
+    properties.surface = nullptr;   // skin surface for reflection properties
+    properties.visible = true;
+
+    // PMT
+    if(obj_name.find("Hamamatsu_R14374") != std::string::npos)
+    {
+        properties.material = glass;
+        properties.colour   = G4Colour(1.0, 0.6, 0.5, 0.7); //slightly transparent red
+    }
+
+    // glass sphere
+    else if (obj_name.find("GlasHemisphere") != std::string::npos)
+    {
+        properties.material = glass;
+        properties.colour   = G4Colour(1.0, 1.0, 1.0, 0.3); // transparent white
+    }
+
+    // titanium flange
+    else if (obj_name.find("Titan_flange") != std::string::npos || obj_name.find("fla-ti_revCsp_up") != std::string::npos)
+    {
+        properties.surface  = titaniumSurface;
+        properties.material = titanium;
+        properties.colour   = G4Colour(0.9, 0.9, 0.9, 1.0); // light grey
+    }
+
+    // HV base
+    else if (obj_name.find("HV_divider") != std::string::npos)
+    {
+        properties.surface  = plasticSurface;
+        properties.material = plastic;
+        properties.colour   = G4Colour(0.2, 0.4, 0.2, 1.0); // dark green
+    }
+
+    // spring
+    else if (obj_name.find("spring") != std::string::npos)
+    {
+        properties.surface  = titaniumSurface;
+        properties.material = titanium;
+        properties.colour   = G4Colour(0.9, 0.9, 0.9, 1.0); // light grey
+    }
+
+    // gel
+    else if (obj_name.find("Optical_gel") != std::string::npos)
+    {
+        properties.material = gel;
+        properties.colour   = G4Colour(1.0, 1.0, 1.0, 0.4); // transparent white
+    }
+
+    // cable breakout
+    else if (obj_name.find("cable_breakout") != std::string::npos)
+    {
+        properties.surface  = titaniumSurface;
+        properties.material = titanium;
+        properties.colour   = G4Colour(0.7, 0.7, 0.7, 1.0); // grey
+    }
+
+    // frame
+    else if (obj_name.find("frame") != std::string::npos)
+    {
+        properties.surface  = plasticSurface;
+        properties.material = plastic;
+        properties.colour   = G4Colour(0.2, 0.2, 0.2, 1.0); // almost black
+    }
+
+    // glass sphere (v13)
+    else if (obj_name.find("HS-BOR-17-09") != std::string::npos)
+    {
+        properties.material = glass;
+        properties.colour   = G4Colour(1.0, 1.0, 1.0, 0.3); // transparent white
+    }
+
+    // titanium flange (v13)
+    else if (obj_name.find("FLA-TI-17-14") != std::string::npos || obj_name.find("fla-ti_revCsp_up") != std::string::npos)
+    {
+        properties.surface  = titaniumSurface;
+        properties.material = titanium;
+        properties.colour   = G4Colour(0.9, 0.9, 0.9, 1.0); // light grey
+    }
+
+    // titanium backplate (v13)
+    else if (obj_name.find("10136520") != std::string::npos || obj_name.find("fla-ti_revCsp_up") != std::string::npos)
+    {
+        properties.surface  = titaniumSurface;
+        properties.material = titanium;
+        properties.colour   = G4Colour(0.9, 0.9, 0.9, 1.0); // light grey
+    }
+
+    // titanium ring (v13)
+    else if (obj_name.find("052-10132172") != std::string::npos || obj_name.find("fla-ti_revCsp_up") != std::string::npos)
+    {
+        properties.surface  = titaniumSurface;
+        properties.material = titanium;
+        properties.colour   = G4Colour(0.9, 0.9, 0.9, 1.0); // light grey
+    }
+
+    // cable breakout 1 (v13)
+    else if (obj_name.find("014-10132184") != std::string::npos)
+    {
+        properties.surface  = titaniumSurface;
+        properties.material = titanium;
+        properties.colour   = G4Colour(0.7, 0.7, 0.7, 1.0); // grey
+    }
+
+    // cable breakout 2 (v13)
+    else if (obj_name.find("051-10132214") != std::string::npos)
+    {
+        properties.surface  = titaniumSurface;
+        properties.material = titanium;
+        properties.colour   = G4Colour(0.7, 0.7, 0.7, 1.0); // grey
+    }
+
+    // cable breakout 3 (v13)
+    else if (obj_name.find("BR101") != std::string::npos)
+    {
+        properties.surface  = titaniumSurface;
+        properties.material = plastic;
+        properties.colour   = G4Colour(0.2, 0.2, 0.2, 1.0); // almost black
+    }
+
+    // water
+    else if (obj_name.find("water") != std::string::npos)
+    {
+        properties.material = water;
+        properties.colour   = G4Colour(0.1, 0.1, 0.5, 0.3); // transparent dark blue
+    }
+
+    // air
+    else if (obj_name.find("air") != std::string::npos)
+    {
+        properties.material = air;
+        properties.visible  = false; // transparent
+    }
+
+    // plastic is assumed (PMT mounting etc..)
+    else
+    {
+        properties.surface  = plasticSurface;
+        properties.material = plastic;
+        properties.colour   = G4Colour(0.2, 0.2, 0.2, 1.0); // almost black
+    }
+
+    return properties;
+}
+
+void OMConstruction::configureGDMLObjects()
+{
     //-----------
     // set world material
     //-----------
 
-    this->_world_logical->SetMaterial(air);
+    this->_world_logical->SetMaterial(this->_MaterialManager->BuildAir());
      
     //-----------
     // loop through objects and set properties
     //-----------
 
+    // logical volumes shared by several placements are configured once
+    std::set<G4LogicalVolume*> configured;
+
     const int nr_of_objects = this->_world_logical->GetNoDaughters();
     for(int i=0; i<nr_of_objects; i++)
     {
         G4VPhysicalVolume* obj_phsical  = this->_world_logical->GetDaughter(i);
         G4LogicalVolume*   obj_logical  = obj_phsical->GetLogicalVolume();
-        G4VSolid*          obj_solid    = obj_logical->GetSolid();
         G4String           obj_name     = obj_phsical->GetName();
-        G4Material*        obj_material = nullptr;
-        G4VisAttributes*   obj_vis = new G4VisAttributes();
 
-        // PMT
-        if(obj_name.find("Hamamatsu_R14374") != std::string::npos)
-        {
-            obj_material = glass;
-            obj_vis->SetColor(1.0, 0.6, 0.5, 0.7); //slightly transparent red
-        }
+        if (!configured.insert(obj_logical).second) continue;
 
-        // glass sphere
-        else if (obj_name.find("GlasHemisphere") != std::string::npos)
-        {
-            obj_material = glass;
-            obj_vis->SetColor(1.0, 1.0, 1.0, 0.3); // transparent white
-        }
+        GDMLObjectProperties properties = this->getGDMLObjectProperties(obj_name);
 
-        // titanium flange
-        else if (obj_name.find("Titan_flange") != std::string::npos || obj_name.find("fla-ti_revCsp_up") != std::string::npos)
-        {
-            // wrap in titanium surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, titaniumSurface);
+        // wrap in surface for reflection properties
+        if (properties.surface != nullptr) new G4LogicalSkinSurface(obj_name, obj_logical, properties.surface);
 
-            obj_material = titanium;
-            obj_vis->SetColor(0.9, 0.9, 0.9, 1.0); // light grey
-        }
+        G4VisAttributes* obj_vis = new G4VisAttributes(properties.colour);
+        obj_vis->SetVisibility(properties.visible);
 
-        // HV base
-        else if (obj_name.find("HV_divider") != std::string::npos)
-        {
-            // wrap in plastic surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, plasticSurface);
+        obj_logical->SetMaterial(properties.material);
+        obj_logical->SetVisAttributes(obj_vis);
+    }
+}
 
-            obj_material = plastic;
-            obj_vis->SetColor(0.2, 0.4, 0.2, 1.0); // dark green
-        }
+void OMConstruction::deduplicateGDMLObjects()
+{
+    //-----------
+    // meshes identical up to a rigid transform share one solid and logical volume
+    //-----------
 
-        // spring
-        else if (obj_name.find("spring") != std::string::npos)
-        {
-            // wrap in titanium surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, titaniumSurface);
+    struct Shape
+    {
+        G4LogicalVolume*     logical;
+        OMMesh               mesh;
+        GDMLObjectProperties properties;
+    };
 
-            obj_material = titanium;
-            obj_vis->SetColor(0.9, 0.9, 0.9, 1.0); // light grey
-        }
+    typedef std::pair<G4LogicalVolume*, G4Transform3D> Replacement;   // shape and its transform onto the duplicate
 
-        // gel
-        else if (obj_name.find("Optical_gel") != std::string::npos)
-        {
-            obj_material = gel;
-            obj_vis->SetColor(1.0, 1.0, 1.0, 0.4); // transparent white
-        }
+    std::vector<Shape>                           shapes;
+    std::set<G4LogicalVolume*>                   seen;
+    std::map<G4LogicalVolume*, Replacement>      replaced;
+    G4int                                        nr_of_meshes   = 0;
+    G4int                                        removed_facets = 0;
 
-        // cable breakout
-        else if (obj_name.find("cable_breakout") != std::string::npos)
-        {
-            // wrap in titanium surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, titaniumSurface);
+    const int nr_of_objects = this->_world_logical->GetNoDaughters();
+    for(int i=0; i<nr_of_objects; i++)
+    {
+        G4VPhysicalVolume* obj_phsical = this->_world_logical->GetDaughter(i);
+        G4LogicalVolume*   obj_logical = obj_phsical->GetLogicalVolume();
 
-            obj_material = titanium;
-            obj_vis->SetColor(0.7, 0.7, 0.7, 1.0); // grey
-        }
+        if (obj_logical->GetSolid()->GetEntityType() != "G4TessellatedSolid" || obj_logical->GetNoDaughters() > 0) continue;
+
+        // logical volumes placed more than once are compared once
+        if (!seen.insert(obj_logical).second && !replaced.count(obj_logical)) continue;
 
-        // frame
-        else if (obj_name.find("frame") != std::string::npos)
+        if (!replaced.count(obj_logical))
         {
-            // wrap in plastic surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, plasticSurface);
+            nr_of_meshes++;
 
-            obj_material = plastic;
-            obj_vis->SetColor(0.2, 0.2, 0.2, 1.0); // almost black
-        }
+            OMMesh               mesh       = OMMeshTools::getMesh(static_cast<G4TessellatedSolid*>(obj_logical->GetSolid()));
+            GDMLObjectProperties properties = this->getGDMLObjectProperties(obj_phsical->GetName());
 
-        // glass sphere (v13)
-        else if (obj_name.find("HS-BOR-17-09") != std::string::npos)
-        {
-            obj_material = glass;
-            obj_vis->SetColor(1.0, 1.0, 1.0, 0.3); // transparent white
-        }
+            for (const Shape& shape : shapes)
+            {
+                // only parts that are configured identically can share a logical volume
+                if (shape.properties.material != properties.material || shape.properties.surface != properties.surface ||
+                    shape.properties.colour   != properties.colour   || shape.properties.visible != properties.visible) continue;
 
-        // titanium flange (v13)
-        else if (obj_name.find("FLA-TI-17-14") != std::string::npos || obj_name.find("fla-ti_revCsp_up") != std::string::npos)
-        {
-            // wrap in titanium surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, titaniumSurface);
+                G4Transform3D shape_to_mesh;
+                if (!OMMeshTools::findRigidTransform(shape.mesh, mesh, shape_to_mesh)) continue;
+
+                replaced.emplace(obj_logical, std::make_pair(shape.logical, shape_to_mesh));
+                removed_facets += mesh.facets.size();
+                break;
+            }
 
-            obj_material = titanium;
-            obj_vis->SetColor(0.9, 0.9, 0.9, 1.0); // light grey
+            if (!replaced.count(obj_logical))
+            {
+                shapes.push_back({obj_logical, mesh, properties});
+                continue;
+            }
         }
 
-        // titanium backplate (v13)
-        else if (obj_name.find("10136520") != std::string::npos || obj_name.find("fla-ti_revCsp_up") != std::string::npos)
-        {
-            // wrap in titanium surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, titaniumSurface);
+        // place the shared shape where the duplicate was
+        const Replacement& replacement = replaced.at(obj_logical);
+        G4Transform3D placement = G4Transform3D(obj_phsical->GetObjectRotationValue(), obj_phsical->GetObjectTranslation()) * replacement.second;
 
-            obj_material = titanium;
-            obj_vis->SetColor(0.9, 0.9, 0.9, 1.0); // light grey
-        }
+        obj_phsical->SetLogicalVolume(replacement.first);
+        this->setPlacement(obj_phsical, placement);
+    }
 
-        // titanium ring (v13)
-        else if (obj_name.find("052-10132172") != std::string::npos || obj_name.find("fla-ti_revCsp_up") != std::string::npos)
-        {
-            // wrap in titanium surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, titaniumSurface);
+    // duplicates are not referenced anymore and not configured yet
+    for (auto& duplicate : replaced)
+    {
+        delete duplicate.first->GetSolid();
+        delete duplicate.first;
+    }
 
-            obj_material = titanium;
-            obj_vis->SetColor(0.9, 0.9, 0.9, 1.0); // light grey
-        }
+    G4cout << ">> " << nr_of_meshes << " tessellated meshes, " << shapes.size() << " unique shapes, "
+           << removed_facets << " facets saved by sharing identical meshes" << G4endl;
+}
 
-        // cable breakout 1 (v13)
-        else if (obj_name.find("014-10132184") != std::string::npos)
-        {
-            // wrap in titanium surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, titaniumSurface);
+void OMConstruction::decimateGDMLObjects()
+{
+    //-----------
+    // simplify opaque mechanical parts, optically relevant volumes keep their full resolution
+    //-----------
 
-            obj_material = titanium;
-            obj_vis->SetColor(0.7, 0.7, 0.7, 1.0); // grey
-        }
+    G4Material* plastic  = this->_MaterialManager->BuildPlastic();
+    G4Material* titanium = this->_MaterialManager->BuildTitanium();
 
-        // cable breakout 2 (v13)
-        else if (obj_name.find("051-10132214") != std::string::npos)
-        {
-            // wrap in titanium surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, titaniumSurface);
+    std::set<G4LogicalVolume*> seen;
+    G4int                      facets_before = 0;
+    G4int                      facets_after  = 0;
 
-            obj_material = titanium;
-            obj_vis->SetColor(0.7, 0.7, 0.7, 1.0); // grey
-        }
+    const int nr_of_objects = this->_world_logical->GetNoDaughters();
+    for(int i=0; i<nr_of_objects; i++)
+    {
+        G4VPhysicalVolume* obj_phsical = this->_world_logical->GetDaughter(i);
+        G4LogicalVolume*   obj_logical = obj_phsical->GetLogicalVolume();
 
-        // cable breakout 3 (v13)
-        else if (obj_name.find("BR101") != std::string::npos)
-        {
-            // wrap in titanium surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, titaniumSurface);
+        if (obj_logical->GetSolid()->GetEntityType() != "G4TessellatedSolid" || obj_logical->GetNoDaughters() > 0) continue;
 
-            obj_material = plastic;
-            obj_vis->SetColor(0.2, 0.2, 0.2, 1.0); // almost black
-        }
+        // shared logical volumes are decimated once
+        if (!seen.insert(obj_logical).second) continue;
 
-        // water
-        else if (obj_name.find("water") != std::string::npos)
-        {
-            obj_material = water;
-            obj_vis->SetColor(0.1, 0.1, 0.5, 0.3); // transparent dark blue
-        }
+        GDMLObjectProperties properties = this->getGDMLObjectProperties(obj_phsical->GetName());
+        if (properties.material != plastic && properties.material != titanium) continue;
+
+        G4TessellatedSolid* solid   = static_cast<G4TessellatedSolid*>(obj_logical->GetSolid());
+        G4TessellatedSolid* reduced = OMMeshTools::decimate(solid, this->_decimation_tolerance);
+
+        const G4int nr_of_facets = solid->GetNumberOfFacets();
+        facets_before += nr_of_facets;
 
-        // air
-        else if (obj_name.find("air") != std::string::npos)
+        // meshes which are not closed or can not be reduced stay as they are
+        if (reduced == nullptr)
         {
-            obj_material = air;
-            obj_vis->SetVisibility(false); // transparent
+            facets_after += nr_of_facets;
+            continue;
         }
 
-        // plastic is assumed (PMT mounting etc..)
-        else
-        {
-            // wrap in plastic surface for reflection properties
-            new G4LogicalSkinSurface(obj_name, obj_logical, plasticSurface);
+        facets_after += reduced->GetNumberOfFacets();
+        G4cout << ">> decimated " << obj_phsical->GetName() << ": " << nr_of_facets << " -> " << reduced->GetNumberOfFacets() << " facets" << G4endl;
 
-            obj_material = plastic;
-            obj_vis->SetColor(0.2, 0.2, 0.2, 1.0); // almost black
-        }
+        obj_logical->SetSolid(reduced);
+        delete solid;
+    }
 
-        obj_logical->SetMaterial(obj_material);
-        obj_logical->SetVisAttributes(obj_vis);
+    G4cout << ">> decimation to " << this->_decimation_tolerance / mm << " mm: " << facets_before << " -> " << facets_after << " facets in mechanical parts" << G4endl;
+}
+
+void OMConstruction::fitGDMLPrimitives()
+{
+    //-----------
+    // meshes approximating spheres, tubes, cones or ellipsoids are replaced by the analytic solid
+    //-----------
+
+    std::map<G4LogicalVolume*, G4Transform3D> fitted;     // logical volume and the placement of the primitive in its mesh frame
+    std::set<G4LogicalVolume*>                seen;
+    G4int                                     removed_facets = 0;
+
+    const int nr_of_objects = this->_world_logical->GetNoDaughters();
+    for(int i=0; i<nr_of_objects; i++)
+    {
+        G4VPhysicalVolume* obj_phsical = this->_world_logical->GetDaughter(i);
+        G4LogicalVolume*   obj_logical = obj_phsical->GetLogicalVolume();
+
+        if (obj_logical->GetSolid()->GetEntityType() != "G4TessellatedSolid" || obj_logical->GetNoDaughters() > 0) continue;
+        if (!seen.insert(obj_logical).second) continue;
+
+        G4TessellatedSolid* solid = static_cast<G4TessellatedSolid*>(obj_logical->GetSolid());
+        G4Transform3D       placement;
+        G4VSolid*           primitive = OMMeshTools::fitPrimitive(solid, this->_primitive_tolerance, placement);
+        if (primitive == nullptr) continue;
+
+        G4cout << ">> " << obj_phsical->GetName() << " (" << solid->GetNumberOfFacets() << " facets) replaced by " << primitive->GetEntityType() << G4endl;
+        removed_facets += solid->GetNumberOfFacets();
+
+        obj_logical->SetSolid(primitive);
+        fitted.emplace(obj_logical, placement);
+        delete solid;
     }
+
+    //-----------
+    // every placement of a replaced mesh carries the transform of the primitive
+    //-----------
+
+    for(int i=0; i<nr_of_objects; i++)
+    {
+        G4VPhysicalVolume* obj_phsical = this->_world_logical->GetDaughter(i);
+        auto               found       = fitted.find(obj_phsical->GetLogicalVolume());
+        if (found == fitted.end()) continue;
+
+        G4Transform3D placement = G4Transform3D(obj_phsical->GetObjectRotationValue(), obj_phsical->GetObjectTranslation()) * found->second;
+        this->setPlacement(obj_phsical, placement);
+    }
+
+    G4cout << ">> " << fitted.size() << " meshes replaced by analytic solids, " << removed_facets << " facets removed" << G4endl;
 }
 
 void OMConstruction::submerge()
@@ -308,9 +698,18 @@ void OMConstruction::submerge()
 
     // as of now, just place some custom code depending on geometry here.
 
+    if (this->_submerge_mode == "hull" && _gdml_filename != "")
+    {
+        if (this->submergeConvexHull()) return;
+        G4cout << ">> submerging by convex hull is not possible, falling back to the boolean water volume" << G4endl;
+    }
+
+    // water is placed in the envelope (if there is one), the positions below are given in world coordinates
+    G4Transform3D world_to_module = G4Transform3D(this->_module_physical->GetObjectRotationValue(), this->_module_physical->GetObjectTranslation()).inverse();
+
     if (_gdml_filename == "")
     {
-        this->_world_logical->SetMaterial(this->_MaterialManager->BuildWater());
+        this->_module_logical->SetMaterial(this->_MaterialManager->BuildWater());
     }
 
     else if ( _gdml_filename == "geometry/P-OM_hemisphere_v13/mother.gdml" ||
@@ -326,6 +725,7 @@ void OMConstruction::submerge()
         G4Point3D to3(0,0,1);
 
         G4Transform3D ou2global(from1, from2, from3, to1, to2, to3);
+        G4Transform3D water_placement = world_to_module * ou2global;
 
         // solids
         G4double air_indside_radius = 207 * mm;
@@ -337,31 +737,32 @@ void OMConstruction::submerge()
                                                 air_indside_radius);
 
         // subtract from air inside
-        G4SubtractionSolid* water = new G4SubtractionSolid("water", this->_world_logical->GetSolid(), air_inside);
+        G4VSolid*           water_mother = new G4DisplacedSolid("water_mother", this->_module_logical->GetSolid(), water_placement.inverse());
+        G4SubtractionSolid* water        = new G4SubtractionSolid("water", water_mother, air_inside);
 
         // subtract overlaps with P-OM
-        const int nr_of_objects = this->_world_logical->GetNoDaughters();
+        const int nr_of_objects = this->_module_logical->GetNoDaughters();
         for(int i=0; i<nr_of_objects; i++)
         {
-            G4VPhysicalVolume* obj_phsical  = this->_world_logical->GetDaughter(i);
+            G4VPhysicalVolume* obj_phsical  = this->_module_logical->GetDaughter(i);
             G4LogicalVolume*   obj_logical  = obj_phsical->GetLogicalVolume();
             G4VSolid*          obj_solid    = obj_logical->GetSolid();
             G4String           obj_name     = obj_phsical->GetName();
 
-            // from relevant parts
+            // from relevant parts (placement is not the identity for deduplicated meshes)
             if (obj_name.find("GlasHemisphere") != std::string::npos)
             {
                 water = new G4SubtractionSolid("water",
                                                 water,
                                                 obj_solid,
-                                                ou2global.inverse());
+                                                water_placement.inverse() * G4Transform3D(obj_phsical->GetObjectRotationValue(), obj_phsical->GetObjectTranslation()));
             }
         }
 
         // logical and placement
         G4LogicalVolume* waterLog = new G4LogicalVolume(water, this->_MaterialManager->BuildWater(), "water"); 
         waterLog->SetVisAttributes(new G4VisAttributes(false));
-        new G4PVPlacement(ou2global, "water", waterLog, this->_world_phsical, false, 0);
+        new G4PVPlacement(water_placement, "water", waterLog, this->_module_physical, false, 0);
     }
 
     else if ( _gdml_filename == "geometry/P-OM_module_v11/mother.gdml"  ||
@@ -393,33 +794,34 @@ void OMConstruction::submerge()
                                                 0);
 
         // subtract from air inside
-        G4VSolid* water = this->_world_logical->GetSolid();
+        G4VSolid* water = new G4DisplacedSolid("water_mother", this->_module_logical->GetSolid(), world_to_module.inverse());
         water = new G4SubtractionSolid("water", water, air_inbetween, new G4RotationMatrix(), G4ThreeVector(0,0,0));
         water = new G4SubtractionSolid("water", water, air_inside_left, new G4RotationMatrix(), G4ThreeVector(0,0,air_middle_offset));
         water = new G4SubtractionSolid("water", water, air_inside_right, new G4RotationMatrix(), G4ThreeVector(0,0,- air_middle_offset));
 
         // subtract overlaps with P-OM
-        const int nr_of_objects = this->_world_logical->GetNoDaughters();
+        const int nr_of_objects = this->_module_logical->GetNoDaughters();
         for(int i=0; i<nr_of_objects; i++)
         {
-            G4VPhysicalVolume* obj_phsical  = this->_world_logical->GetDaughter(i);
+            G4VPhysicalVolume* obj_phsical  = this->_module_logical->GetDaughter(i);
             G4LogicalVolume*   obj_logical  = obj_phsical->GetLogicalVolume();
             G4VSolid*          obj_solid    = obj_logical->GetSolid();
             G4String           obj_name     = obj_phsical->GetName();
 
-            // from relevant parts
+            // from relevant parts (placement is not the identity for deduplicated meshes)
             if (obj_name.find("GlasHemisphere") != std::string::npos)
             {
                 water = new G4SubtractionSolid("water",
                                                 water,
-                                                obj_solid);
+                                                obj_solid,
+                                                world_to_module.inverse() * G4Transform3D(obj_phsical->GetObjectRotationValue(), obj_phsical->GetObjectTranslation()));
             }
         }
 
         // logical and placement
         G4LogicalVolume* waterLog = new G4LogicalVolume(water, this->_MaterialManager->BuildWater(), "water");
         waterLog->SetVisAttributes(new G4VisAttributes(false));
-        new G4PVPlacement(G4Transform3D(), "water", waterLog, this->_world_phsical, false, 0);
+        new G4PVPlacement(world_to_module, "water", waterLog, this->_module_physical, false, 0);
     }
 
     else if ( _gdml_filename == "geometry/P-OM_module_v13/mother.gdml")
@@ -450,42 +852,169 @@ void OMConstruction::submerge()
                                                 0);
 
         // subtract from air inside
-        G4VSolid* water = this->_world_logical->GetSolid();
+        G4VSolid* water = new G4DisplacedSolid("water_mother", this->_module_logical->GetSolid(), world_to_module.inverse());
         water = new G4SubtractionSolid("water", water, air_inbetween, new G4RotationMatrix(), G4ThreeVector(0,0,0));
         water = new G4SubtractionSolid("water", water, air_inside_left, new G4RotationMatrix(), G4ThreeVector(0,0,air_middle_offset));
         water = new G4SubtractionSolid("water", water, air_inside_right, new G4RotationMatrix(), G4ThreeVector(0,0,- air_middle_offset));
 
         // subtract overlaps with P-OM
-        const int nr_of_objects = this->_world_logical->GetNoDaughters();
+        const int nr_of_objects = this->_module_logical->GetNoDaughters();
         for(int i=0; i<nr_of_objects; i++)
         {
-            G4VPhysicalVolume* obj_phsical  = this->_world_logical->GetDaughter(i);
+            G4VPhysicalVolume* obj_phsical  = this->_module_logical->GetDaughter(i);
             G4LogicalVolume*   obj_logical  = obj_phsical->GetLogicalVolume();
             G4VSolid*          obj_solid    = obj_logical->GetSolid();
             G4String           obj_name     = obj_phsical->GetName();
 
-            // from relevant parts
+            // from relevant parts (placement is not the identity for deduplicated meshes)
             if (obj_name.find("GlasHemisphere") != std::string::npos)
             {
                 water = new G4SubtractionSolid("water",
                                                 water,
-                                                obj_solid);
+                                                obj_solid,
+                                                world_to_module.inverse() * G4Transform3D(obj_phsical->GetObjectRotationValue(), obj_phsical->GetObjectTranslation()));
             }
         }
 
         // logical and placement
         G4LogicalVolume* waterLog = new G4LogicalVolume(water, this->_MaterialManager->BuildWater(), "water");
         waterLog->SetVisAttributes(new G4VisAttributes(false));
-        new G4PVPlacement(G4Transform3D(), "water", waterLog, this->_world_phsical, false, 0);
+        new G4PVPlacement(world_to_module, "water", waterLog, this->_module_physical, false, 0);
     }
 
     else
     {
-        G4Exception("void OMConstruction::submerge()",
-                    "no suitable implementation for submerging exist!",
+        if (this->_submerge_mode != "hull")
+        {
+            G4cout << ">> no boolean water volume implemented for " << _gdml_filename << ", submerging by convex hull" << G4endl;
+            if (this->submergeConvexHull()) return;
+        }
+
+        G4Exception("OMConstruction::submerge()",
+                    "can not submerge geometry",
+                    FatalException,
+                    ("There is no boolean water volume for " + _gdml_filename + " and the convex hull of its glass can not be used (see the warnings above).\n"
+                     "Submerge the module without analytic glass parts (/geometry/gdml/primitives 0 mm) or implement a boolean water volume in OMConstruction::submerge()!").c_str());
+        return;
+    }
+
+    // outside of the envelope there is only water
+    this->_world_logical->SetMaterial(this->_MaterialManager->BuildWater());
+}
+
+G4bool OMConstruction::submergeConvexHull()
+{
+    //-----------
+    // the convex hull of the glass housing encloses the air inside the module, everything else is water
+    //-----------
+
+    G4Material* glass = this->_MaterialManager->BuildGlass();
+    G4Material* water = this->_MaterialManager->BuildWater();
+    G4Material* air   = this->_MaterialManager->BuildAir();
+
+    // gelpads and PMTs are always inside
+    std::set<G4VPhysicalVolume*> interior(this->_placed_gelpads.begin(), this->_placed_gelpads.end());
+    interior.insert(this->_placed_pmts.begin(), this->_placed_pmts.end());
+
+    std::vector<G4ThreeVector>      hull_points;
+    std::vector<G4VPhysicalVolume*> candidates;
+
+    const int nr_of_objects = this->_module_logical->GetNoDaughters();
+    for(int i=0; i<nr_of_objects; i++)
+    {
+        G4VPhysicalVolume* obj_phsical = this->_module_logical->GetDaughter(i);
+        if (interior.count(obj_phsical)) continue;
+
+        if (obj_phsical->GetLogicalVolume()->GetMaterial() == glass)
+        {
+            // the hull has to lie on the outer glass surface, otherwise a thin air shell separates water and glass.
+            // Only mesh vertices are exactly on the surface, the polygons of analytic solids are not
+            if (obj_phsical->GetLogicalVolume()->GetSolid()->GetEntityType() != "G4TessellatedSolid")
+            {
+                G4Exception("OMConstruction::submergeConvexHull()",
+                            "analytic glass part",
+                            JustWarning,
+                            ("The glass part " + obj_phsical->GetName() + " is not tessellated (replaced by an analytic solid?), "
+                             "the convex hull would not coincide with its outer surface.").c_str());
+                return false;
+            }
+
+            std::vector<G4ThreeVector> points = this->getEnclosingPoints(obj_phsical);
+            hull_points.insert(hull_points.end(), points.begin(), points.end());
+            interior.insert(obj_phsical);
+        }
+        else candidates.push_back(obj_phsical);
+    }
+
+    G4TessellatedSolid* hull = OMMeshTools::convexHull("air", hull_points);
+    if (hull == nullptr)
+    {
+        G4Exception("OMConstruction::submergeConvexHull()",
+                    "no housing found",
                     JustWarning,
-                    "No suitable implementation exists for submerging the existing geometry in water. Will continue run with air world.\nPlease implement a method in OMConstruction::submerge() to make this warning disappear.");
+                    "The imported geometry contains no glass parts enclosing a volume. The whole module is placed in water.");
+        this->_module_logical->SetMaterial(water);
+        this->_world_logical->SetMaterial(water);
+        return true;
+    }
+
+    //-----------
+    // parts completely inside the hull are moved into the air, parts completely outside stay in water
+    //-----------
+
+    for (auto candidate = candidates.begin(); candidate != candidates.end();)
+    {
+        std::vector<G4ThreeVector> points = this->getEnclosingPoints(*candidate);
+
+        size_t nr_inside = 0;
+        for (const G4ThreeVector& point : points) if (hull->Inside(point) != kOutside) nr_inside++;
+
+        if (nr_inside == 0)
+        {
+            candidate++;
+            continue;
+        }
+
+        // enlarging the hull would turn the water around the part into air
+        if (nr_inside < points.size())
+        {
+            G4Exception("OMConstruction::submergeConvexHull()",
+                        "part crosses the housing",
+                        JustWarning,
+                        ("The part " + (*candidate)->GetName() + " is partly inside and partly outside of the convex hull of the glass.").c_str());
+            delete hull;
+            return false;
+        }
+
+        interior.insert(*candidate);
+        candidate = candidates.erase(candidate);
     }
+
+    this->_module_logical->SetMaterial(water);
+    this->_world_logical->SetMaterial(water);
+
+    //-----------
+    // move the interior into the air volume, it is placed without transform so daughters keep their placement
+    //-----------
+
+    G4LogicalVolume* air_logical = new G4LogicalVolume(hull, air, "air");
+    air_logical->SetVisAttributes(new G4VisAttributes(false));
+
+    std::vector<G4VPhysicalVolume*> daughters;
+    for(int i=0; i<nr_of_objects; i++) if (interior.count(this->_module_logical->GetDaughter(i))) daughters.push_back(this->_module_logical->GetDaughter(i));
+
+    for (G4VPhysicalVolume* obj_phsical : daughters)
+    {
+        this->_module_logical->RemoveDaughter(obj_phsical);
+        obj_phsical->SetMotherLogical(air_logical);
+        air_logical->AddDaughter(obj_phsical);
+    }
+
+    this->_interior_physical = new G4PVPlacement(G4Transform3D(), air_logical, "air", this->_module_logical, false, 0);
+
+    G4cout << ">> submerged: " << daughters.size() << " volumes inside the housing (convex hull with " << hull->GetNumberOfFacets()
+           << " facets), " << candidates.size() << " volumes in water" << G4endl;
+    return true;
 }
 
 void OMConstruction::placeOpticalUnits()
@@ -514,6 +1043,12 @@ void OMConstruction::placeOpticalUnits()
     //G4Transform3D gelpad_offset(G4RotationMatrix(), G4ThreeVector(0, 0, -7.11 * mm));
     G4Transform3D PMTOffset(G4RotationMatrix(G4ThreeVector(1,0,0), 90 * degree), G4ThreeVector(0, 0, - 53 * mm));
 
+    // custom glass sphere giving the curvature of the gelpads if no gdml glass is imported
+    G4double      sphere_radius         = 201.90 * mm;
+    G4double      pmt_to_glass_distance =      2 * mm;
+    G4Transform3D sphere_transform(G4RotationMatrix(), G4ThreeVector(0, 0, sphere_radius - pmt_to_glass_distance));
+    G4Orb*        sphere_solid = new G4Orb("gelpad_glass_subtr_solid", sphere_radius);
+
     for(int i=0; i < this->_nr_of_OUs; i++)
     {
         //-----------
@@ -547,58 +1082,80 @@ void OMConstruction::placeOpticalUnits()
         G4Transform3D ouPlacementTransform(G4RotationMatrix(cross, delta), ou_pos);
 
         //-----------
-        // subtract relevant solids from gelpad
+        // glass the gelpad is pressed against, placed in the gelpad frame
         //-----------
 
-        G4VSolid* gelpad_solid_to_place = this->_gelpad_solid;
-        
-        // from gdml glass
-        G4bool glass_subtracted = false;
+        std::vector<std::pair<G4VSolid*, G4Transform3D>> glass_parts;
         const int nr_of_objects = this->_world_logical->GetNoDaughters();
         for(int i=0; i<nr_of_objects; i++)
         {
             G4VPhysicalVolume* obj_phsical  = this->_world_logical->GetDaughter(i);
-            G4LogicalVolume*   obj_logical  = obj_phsical->GetLogicalVolume();
-            G4VSolid*          obj_solid    = obj_logical->GetSolid();
             G4String           obj_name     = obj_phsical->GetName();
-            
+
             if (obj_name.find("GlasHemisphere") != std::string::npos)
             {
-                gelpad_solid_to_place = new G4SubtractionSolid("gelpad",
-                                                                gelpad_solid_to_place,
-                                                                obj_solid,
-                                                                gelpad_offset.inverse() * ouPlacementTransform.inverse());
-                glass_subtracted = true;
+                glass_parts.push_back({obj_phsical->GetLogicalVolume()->GetSolid(),
+                                       gelpad_offset.inverse() * ouPlacementTransform.inverse() *
+                                       G4Transform3D(obj_phsical->GetObjectRotationValue(), obj_phsical->GetObjectTranslation())});
             }
         }
+        G4bool glass_subtracted = !glass_parts.empty();
 
-        // if gelpad is not subracted from gdml glass, subreact from custom glass sphere (to get the curvature right)
-        if (!glass_subtracted)
+        //-----------
+        // reuse a gelpad of matching curvature
+        //-----------
+
+        G4LogicalVolume* gelpad_logical = nullptr;
+        if (this->_gelpad_tolerance > 0)
         {
-            G4double sphere_radius         = 201.90 * mm;
-            G4double pmt_to_glass_distance =      2 * mm;
-            G4Transform3D sphere_transform(G4RotationMatrix(), G4ThreeVector(0, 0, sphere_radius - pmt_to_glass_distance));
-            gelpad_solid_to_place = new G4IntersectionSolid("gelpad",
-                                                            gelpad_solid_to_place,
-                                                            new G4Orb("gelpad_glass_subtr_solid", sphere_radius),
-                                                            gelpad_offset.inverse() * sphere_transform.inverse());
+            if (!glass_subtracted) glass_parts.push_back({sphere_solid, gelpad_offset.inverse() * sphere_transform.inverse()});
+            gelpad_logical = this->getSharedGelpad(glass_parts, gelpad_offset.inverse() * PMTOffset);
         }
 
-        // from PMT
-        gelpad_solid_to_place = new G4SubtractionSolid("gelpad",
-                                                        gelpad_solid_to_place,
-                                                        this->_pmt_logical->GetSolid(),
-                                                        gelpad_offset.inverse() * PMTOffset);
+        if (gelpad_logical == nullptr)
+        {
+            //-----------
+            // subtract relevant solids from gelpad
+            //-----------
 
+            G4VSolid* gelpad_solid_to_place = this->_gelpad_solid;
 
-        //-----------
-        // create and configure logical volume for gelpad
-        //-----------
+            // from gdml glass
+            if (glass_subtracted)
+            {
+                for (const auto& glass_part : glass_parts)
+                {
+                    gelpad_solid_to_place = new G4SubtractionSolid("gelpad",
+                                                                    gelpad_solid_to_place,
+                                                                    glass_part.first,
+                                                                    glass_part.second);
+                }
+            }
+
+            // if gelpad is not subracted from gdml glass, subreact from custom glass sphere (to get the curvature right)
+            else
+            {
+                gelpad_solid_to_place = new G4IntersectionSolid("gelpad",
+                                                                gelpad_solid_to_place,
+                                                                sphere_solid,
+                                                                gelpad_offset.inverse() * sphere_transform.inverse());
+            }
+
+            // from PMT
+            gelpad_solid_to_place = new G4SubtractionSolid("gelpad",
+                                                            gelpad_solid_to_place,
+                                                            this->_pmt_logical->GetSolid(),
+                                                            gelpad_offset.inverse() * PMTOffset);
 
-        G4LogicalVolume* gelpad_logical = new G4LogicalVolume(gelpad_solid_to_place, gel, "gelpad");
-        G4VisAttributes* gelpad_vis = new G4VisAttributes();
-        gelpad_vis->SetColor(1,1,1,0.4);
-        gelpad_logical->SetVisAttributes(gelpad_vis);
+            //-----------
+            // create and configure logical volume for gelpad
+            //-----------
+
+            gelpad_logical = new G4LogicalVolume(gelpad_solid_to_place, gel, "gelpad");
+            G4VisAttributes* gelpad_vis = new G4VisAttributes();
+            gelpad_vis->SetColor(1,1,1,0.4);
+            gelpad_logical->SetVisAttributes(gelpad_vis);
+        }
 
         //-----------
         // place gelpad and pmt
@@ -618,16 +1175,6 @@ void OMConstruction::placeOpticalUnits()
                                                              false,                    // no boolean operations
                                                              i);                       // its copy number
        
-        //-----------
-        // set reflector around gelpad
-        //-----------
-
-        if ( this->getSolidReflector() )
-        {
-            new G4LogicalBorderSurface("gelpadSolidReflectorInside", gelpad_placement, this->_world_phsical, this->_MaterialManager->BuildReflectorSurface());
-            new G4LogicalBorderSurface("gelpadSolidReflectorOutside", this->_world_phsical, gelpad_placement, this->_MaterialManager->BuildReflectorSurface());
-        }
-
         //-----------
         // set reflector surface to pmt
         //-----------
@@ -644,6 +1191,260 @@ void OMConstruction::placeOpticalUnits()
         this->_placed_gelpads.push_back(gelpad_placement);
         this->_placed_pmts.push_back(pmt_placement);
     }
+
+    if (this->_gelpad_tolerance > 0)
+    {
+        G4cout << ">> " << this->_shared_gelpads.size() << " shared gelpad shapes for " << this->_nr_of_OUs << " optical units" << G4endl;
+    }
+}
+
+G4LogicalVolume* OMConstruction::getSharedGelpad(const std::vector<std::pair<G4VSolid*, G4Transform3D>>& glass_parts, const G4Transform3D& pmt_offset)
+{
+    //-----------
+    // sample the glass surface above the gelpad with rays along the gelpad axis, starting below the gelpad
+    //-----------
+
+    G4ThreeVector lower, upper;
+    this->_gelpad_solid->BoundingLimits(lower, upper);
+    const G4double footprint = std::max(std::max(-lower.x(), upper.x()), std::max(-lower.y(), upper.y()));
+
+    const G4int nr_of_rings = 8;
+    const G4int nr_of_rays  = 16;
+
+    std::vector<G4ThreeVector> surface;
+    for (G4int ring = 0; ring <= nr_of_rings; ring++)
+    {
+        for (G4int ray = 0; ray < (ring == 0 ? 1 : nr_of_rays); ray++)
+        {
+            G4double      rho = footprint * ring / nr_of_rings;
+            G4double      phi = 2 * pi * ray / nr_of_rays;
+            G4ThreeVector start(rho * std::cos(phi), rho * std::sin(phi), lower.z());
+
+            G4double distance = kInfinity;
+            for (const auto& glass_part : glass_parts)
+            {
+                G4Transform3D to_part = glass_part.second.inverse();
+                G4ThreeVector point   = G4Point3D(start).transform(to_part);
+                G4ThreeVector axis    = to_part.getRotation() * G4ThreeVector(0, 0, 1);
+
+                EInside inside = glass_part.first->Inside(point);
+                if      (inside == kOutside) distance = std::min(distance, glass_part.first->DistanceToIn(point, axis));
+                else if (inside == kInside)  distance = std::min(distance, glass_part.first->DistanceToOut(point, axis));
+            }
+            if (distance < kInfinity) surface.push_back(start + G4ThreeVector(0, 0, distance));
+        }
+    }
+
+    //-----------
+    // reuse a gelpad whose sphere matches the samples, or fit a new one
+    //-----------
+
+    auto deviation = [&surface](const G4ThreeVector& centre, G4double radius)
+    {
+        G4double max_deviation = 0;
+        for (const G4ThreeVector& point : surface) max_deviation = std::max(max_deviation, std::fabs((point - centre).mag() - radius));
+        return max_deviation;
+    };
+
+    for (const SharedGelpad& shared : this->_shared_gelpads)
+    {
+        if (deviation(shared.centre, shared.radius) <= this->_gelpad_tolerance) return shared.logical;
+    }
+
+    G4ThreeVector centre;
+    G4double      radius;
+    G4double      residual = OMMeshTools::fitSphere(surface, centre, radius);
+    if (surface.size() < size_t(nr_of_rings * nr_of_rays / 2) || residual < 0 || residual > this->_gelpad_tolerance)
+    {
+        G4cout << ">> glass above gelpad " << this->_placed_gelpads.size() << " is not spherical within " << this->_gelpad_tolerance / mm
+               << " mm, the gelpad is cut by the glass itself" << G4endl;
+        return nullptr;
+    }
+
+    G4VSolid* gelpad_solid = new G4IntersectionSolid("gelpad",
+                                                     this->_gelpad_solid,
+                                                     new G4Orb("gelpad_glass_solid", radius),
+                                                     G4Transform3D(G4RotationMatrix(), centre));
+    gelpad_solid = new G4SubtractionSolid("gelpad", gelpad_solid, this->_pmt_logical->GetSolid(), pmt_offset);
+
+    G4LogicalVolume* gelpad_logical = new G4LogicalVolume(gelpad_solid, this->_MaterialManager->BuildGel(), "gelpad");
+    G4VisAttributes* gelpad_vis = new G4VisAttributes();
+    gelpad_vis->SetColor(1,1,1,0.4);
+    gelpad_logical->SetVisAttributes(gelpad_vis);
+
+    this->_shared_gelpads.push_back({centre, radius, gelpad_logical});
+    G4cout << ">> shared gelpad " << this->_shared_gelpads.size() << ": glass radius " << radius / mm << " mm, deviation "
+           << residual / mm << " mm" << G4endl;
+    return gelpad_logical;
+}
+
+void OMConstruction::placeSolidReflectors()
+{
+    // reflector around the gelpads, towards the volume they are placed in
+    G4VPhysicalVolume* mother = this->_interior_physical != nullptr ? this->_interior_physical : this->_module_physical;
+    for (G4VPhysicalVolume* gelpad_placement : this->_placed_gelpads)
+    {
+        new G4LogicalBorderSurface("gelpadSolidReflectorInside", gelpad_placement, mother, this->_MaterialManager->BuildReflectorSurface());
+        new G4LogicalBorderSurface("gelpadSolidReflectorOutside", mother, gelpad_placement, this->_MaterialManager->BuildReflectorSurface());
+    }
+}
+
+void OMConstruction::setPlacement(G4VPhysicalVolume* physical, const G4Transform3D& placement)
+{
+    // the placement keeps the inverse rotation (frame rotation), identity placements have none
+    G4RotationMatrix  frame_rotation = placement.getRotation().inverse();
+    G4RotationMatrix* rotation       = physical->GetRotation();
+    if (rotation != nullptr)
+    {
+        *rotation = frame_rotation;
+    }
+    else if (!frame_rotation.isIdentity())
+    {
+        // matrices not owned by the placement are kept until the construction is deleted
+        rotation = new G4RotationMatrix(frame_rotation);
+        this->_placement_rotations.push_back(rotation);
+        physical->SetRotation(rotation);
+    }
+    physical->SetTranslation(placement.getTranslation());
+}
+
+std::vector<G4ThreeVector> OMConstruction::getEnclosingPoints(G4VPhysicalVolume* physical)
+{
+    G4VSolid*                  solid = physical->GetLogicalVolume()->GetSolid();
+    G4String                   type  = solid->GetEntityType();
+    G4Transform3D              placement(physical->GetObjectRotationValue(), physical->GetObjectTranslation());
+    std::vector<G4ThreeVector> points;
+
+    // mesh vertices
+    if (type == "G4TessellatedSolid")
+    {
+        G4TessellatedSolid* tessellated = static_cast<G4TessellatedSolid*>(solid);
+        for (G4int i = 0; i < tessellated->GetNumberOfFacets(); i++)
+        {
+            G4VFacet* facet = tessellated->GetFacet(i);
+            for (G4int k = 0; k < facet->GetNumberOfVertices(); k++) points.push_back(G4Point3D(facet->GetVertex(k)).transform(placement));
+        }
+    }
+
+    // polyhedron vertices lie on the surface of the primitive, scaled around its centre so the facets enclose the curved surface
+    else if (type == "G4Orb" || type == "G4Sphere" || type == "G4Tubs" || type == "G4Cons" || type == "G4Ellipsoid")
+    {
+        const G4int steps = 180;
+        G4Polyhedron::SetNumberOfRotationSteps(steps);
+        G4Polyhedron* polyhedron = solid->CreatePolyhedron();
+        G4Polyhedron::ResetNumberOfRotationSteps();
+
+        const G4double scale = 1 / std::pow(std::cos(pi / steps), 2);
+        for (G4int i = 1; i <= polyhedron->GetNoVertices(); i++)
+        {
+            points.push_back(G4Point3D(polyhedron->GetVertex(i) * scale).transform(placement));
+        }
+        delete polyhedron;
+    }
+
+    // bounding box corners for everything else
+    else
+    {
+        G4ThreeVector lower, upper;
+        solid->BoundingLimits(lower, upper);
+        for (G4int corner = 0; corner < 8; corner++)
+        {
+            G4Point3D point(corner & 1 ? upper.x() : lower.x(), corner & 2 ? upper.y() : lower.y(), corner & 4 ? upper.z() : lower.z());
+            points.push_back(point.transform(placement));
+        }
+    }
+
+    return points;
+}
+
+void OMConstruction::createEnvelope()
+{
+    const int nr_of_objects = this->_world_logical->GetNoDaughters();
+    if (nr_of_objects == 0) return;
+
+    //-----------
+    // points bounding all daughters of the world, in world coordinates
+    //-----------
+
+    std::vector<G4ThreeVector> points;
+    for(int i=0; i<nr_of_objects; i++)
+    {
+        std::vector<G4ThreeVector> obj_points = this->getEnclosingPoints(this->_world_logical->GetDaughter(i));
+        points.insert(points.end(), obj_points.begin(), obj_points.end());
+    }
+
+    //-----------
+    // sphere or tube along the longest side of the bounding box, whichever is smaller
+    //-----------
+
+    G4ThreeVector lower = points.front(), upper = points.front();
+    for (const G4ThreeVector& point : points)
+    {
+        for (G4int k = 0; k < 3; k++)
+        {
+            lower[k] = std::min(lower[k], point[k]);
+            upper[k] = std::max(upper[k], point[k]);
+        }
+    }
+    G4ThreeVector centre = (lower + upper) / 2;
+    G4ThreeVector size   = upper - lower;
+    G4int         axis   = size.x() >= size.y() && size.x() >= size.z() ? 0 : (size.y() >= size.z() ? 1 : 2);
+
+    G4double sphere_radius = 0;
+    G4double tube_radius   = 0;
+    for (const G4ThreeVector& point : points)
+    {
+        G4ThreeVector offset = point - centre;
+        sphere_radius = std::max(sphere_radius, offset.mag());
+        offset[axis]  = 0;
+        tube_radius   = std::max(tube_radius, offset.mag());
+    }
+
+    const G4double margin           = 1 * mm;
+    const G4double tube_half_length = size[axis] / 2 + margin;
+    sphere_radius += margin;
+    tube_radius   += margin;
+
+    G4VSolid*        envelope_solid;
+    G4RotationMatrix envelope_rotation;
+    if (4. / 3 * sphere_radius * sphere_radius * sphere_radius <= 2 * tube_radius * tube_radius * tube_half_length)
+    {
+        envelope_solid = new G4Orb("Envelope", sphere_radius);
+        G4cout << ">> envelope: sphere with radius " << sphere_radius / mm << " mm" << G4endl;
+    }
+    else
+    {
+        envelope_solid = new G4Tubs("Envelope", 0, tube_radius, tube_half_length, 0, 360 * degree);
+        if (axis == 0) envelope_rotation.rotateY(90 * degree);
+        if (axis == 1) envelope_rotation.rotateX(90 * degree);
+        G4cout << ">> envelope: tube with radius " << tube_radius / mm << " mm and length " << 2 * tube_half_length / mm << " mm" << G4endl;
+    }
+
+    //-----------
+    // move all daughters of the world into the envelope
+    //-----------
+
+    G4LogicalVolume* envelope_logical = new G4LogicalVolume(envelope_solid, this->_world_logical->GetMaterial(), "Envelope");
+    envelope_logical->SetVisAttributes(new G4VisAttributes(false));
+
+    G4Transform3D envelope_placement(envelope_rotation, centre);
+    G4Transform3D world_to_envelope = envelope_placement.inverse();
+
+    std::vector<G4VPhysicalVolume*> daughters;
+    for(int i=0; i<nr_of_objects; i++) daughters.push_back(this->_world_logical->GetDaughter(i));
+
+    for (G4VPhysicalVolume* obj_phsical : daughters)
+    {
+        G4Transform3D placement = world_to_envelope * G4Transform3D(obj_phsical->GetObjectRotationValue(), obj_phsical->GetObjectTranslation());
+
+        this->_world_logical->RemoveDaughter(obj_phsical);
+        obj_phsical->SetMotherLogical(envelope_logical);
+        this->setPlacement(obj_phsical, placement);
+        envelope_logical->AddDaughter(obj_phsical);
+    }
+
+    this->_module_logical  = envelope_logical;
+    this->_module_physical = new G4PVPlacement(envelope_placement, envelope_logical, "Envelope", this->_world_logical, false, 0);
 }
 
 void OMConstruction::constructGelpad()
@@ -819,6 +1620,10 @@ void OMConstruction::constructPMT()
     photocathodeLog->SetVisAttributes(photocathode_vis);
     photocathodeTubeLog->SetVisAttributes(photocathode_vis);
 
+    // sensitive detector is attached in ConstructSDandField()
+    this->_photocathode_logicals.push_back(photocathodeLog);
+    this->_photocathode_logicals.push_back(photocathodeTubeLog);
+
 
     //-----------
     // create absorber solid and logical volume (simulate PMT-cascade structures, used to absorb photons)
@@ -867,22 +1672,46 @@ void OMConstruction::constructPMT()
 
     G4double photocathodeTubeOffset = (VacCylinderHeight - photocathode_tube_length) / 2;
 
+    this->_photocathode_centre = G4ThreeVector(0,upperVacSphereOffset,0);
 
-    new G4PVPlacement(new G4RotationMatrix(),
-                      G4ThreeVector(),
-                      photocathodeLog,
-                      "photocathode",
-                      upperVacSphereLog,
-                      false,
-                      0);
 
-    new G4PVPlacement(new G4RotationMatrix(),
-                      G4ThreeVector(0,0,photocathodeTubeOffset),
-                      photocathodeTubeLog,
-                      "photocathodeTube",
-                      VacCylinderLog,
-                      false,
-                      0);
+    if (!this->_flatten_pmt)
+    {
+        new G4PVPlacement(new G4RotationMatrix(),
+                          G4ThreeVector(),
+                          photocathodeLog,
+                          "photocathode",
+                          upperVacSphereLog,
+                          false,
+                          0);
+
+        new G4PVPlacement(new G4RotationMatrix(),
+                          G4ThreeVector(0,0,photocathodeTubeOffset),
+                          photocathodeTubeLog,
+                          "photocathodeTube",
+                          VacCylinderLog,
+                          false,
+                          0);
+    }
+    else
+    {
+        // flattened hierarchy: the vacuum leaves room for the photocathode, which is placed next to it in the pmt.
+        // the photocathode padding is not modelled here (it is 0 in the nested model as well)
+        G4double innerSphereRadius   = VacSphereRadius   - photocathode_thickness;
+        G4double innerCylinderRadius = VacCylinderRadius - photocathode_thickness;
+
+        upperVacSphereLog->SetSolid(new G4Ellipsoid("upperVacSphere",
+                                                    innerSphereRadius,   // x semiaxis
+                                                    innerSphereRadius,   // y semiaxis
+                                                    innerSphereRadius,   // z semiaxis
+                                                    VacSphereCutoff,     // bottom cutoff
+                                                    innerSphereRadius)); // top cutoff
+
+        VacCylinderLog->SetSolid(new G4EllipticalTube("VacCylinder",
+                                                      innerCylinderRadius,    // x semiaxis
+                                                      innerCylinderRadius,    // y semiaxis
+                                                      VacCylinderHeight / 2));// height
+    }
 
     new G4PVPlacement(new G4RotationMatrix(G4ThreeVector(1,0,0), 90 * degree),
                       G4ThreeVector(0,upperVacSphereOffset,0),
@@ -915,6 +1744,43 @@ void OMConstruction::constructPMT()
                       this->_pmt_logical,
                       false,
                       0);
+
+    if (this->_flatten_pmt)
+    {
+        G4RotationMatrix vacRotation = G4RotationMatrix(G4ThreeVector(1,0,0), 90 * degree).inverse();
+        G4Transform3D    upperVacSphereTransform(vacRotation, G4ThreeVector(0,upperVacSphereOffset,0));
+        G4Transform3D    VacCylinderTransform(vacRotation, G4ThreeVector(0,VacCylinderOffset,0));
+
+        new G4PVPlacement(upperVacSphereTransform,
+                          photocathodeLog,
+                          "photocathode",
+                          this->_pmt_logical,
+                          false,
+                          0);
+
+        new G4PVPlacement(VacCylinderTransform * G4Translate3D(0,0,photocathodeTubeOffset),
+                          photocathodeTubeLog,
+                          "photocathodeTube",
+                          this->_pmt_logical,
+                          false,
+                          0);
+
+        // vacuum between the inner cylinder and the glass below the photocathode tube
+        G4double ringHeight = VacCylinderHeight - photocathode_tube_length;
+        if (ringHeight > 0.001 * mm)
+        {
+            G4Tubs*          VacCylinderRing    = new G4Tubs("VacCylinderRing", VacCylinderRadius - photocathode_thickness, VacCylinderRadius, ringHeight / 2, 0, 360 * degree);
+            G4LogicalVolume* VacCylinderRingLog = new G4LogicalVolume(VacCylinderRing, vacuum, "VacCylinderRing");
+            VacCylinderRingLog->SetVisAttributes(vacuum_vis);
+
+            new G4PVPlacement(VacCylinderTransform * G4Translate3D(0,0,-photocathode_tube_length / 2),
+                              VacCylinderRingLog,
+                              "VacCylinderRing",
+                              this->_pmt_logical,
+                              false,
+                              0);
+        }
+    }
 }
 
 void OMConstruction::addOpticalUnit(G4double radius, G4double theta, G4double phi)
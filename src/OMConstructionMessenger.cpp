@@ -18,18 +18,71 @@ OMConstructionMessenger::OMConstructionMessenger(OMConstruction* Constr)
     this->OpticalUnitDir = new G4UIdirectory("/geometry/PMT/");
     this->OpticalUnitDir->SetGuidance("options for the placement of optical units (pmt + gelpad)");
 
+    this->NavigationDir = new G4UIdirectory("/geometry/navigation/");
+    this->NavigationDir->SetGuidance("smartless and voxel settings of the navigation");
+
     this->gdmlfileCmd = new G4UIcmdWithAString("/geometry/gdml/file",this);
     this->gdmlfileCmd->SetGuidance("set the GDML-File to be imported.");
     this->gdmlfileCmd->SetParameterName("filename",false);
     this->gdmlfileCmd->AvailableForStates(G4State_PreInit);
     this->gdmlfileCmd->SetToBeBroadcasted(false);
 
+    this->gdmlCacheCmd = new G4UIcmdWithAString("/geometry/gdml/cache",this);
+    this->gdmlCacheCmd->SetGuidance("directory for a binary cache of the imported geometry. The cache is rebuilt whenever the GDML files change. Empty to disable.");
+    this->gdmlCacheCmd->SetParameterName("directory",true);
+    this->gdmlCacheCmd->SetDefaultValue("");
+    this->gdmlCacheCmd->AvailableForStates(G4State_PreInit);
+    this->gdmlCacheCmd->SetToBeBroadcasted(false);
+
+    this->gdmlThreadsCmd = new G4UIcmdWithAnInteger("/geometry/gdml/threads",this);
+    this->gdmlThreadsCmd->SetGuidance("number of threads reading the per-volume GDML files. 0 uses one thread per core.");
+    this->gdmlThreadsCmd->SetParameterName("threads",false);
+    this->gdmlThreadsCmd->SetRange("threads >= 0");
+    this->gdmlThreadsCmd->AvailableForStates(G4State_PreInit);
+    this->gdmlThreadsCmd->SetToBeBroadcasted(false);
+
+    this->deduplicateCmd = new G4UIcmdWithABool("/geometry/gdml/deduplicate",this);
+    this->deduplicateCmd->SetGuidance("places parts with identical meshes (up to a rotation and translation) as copies of one shared logical volume.");
+    this->deduplicateCmd->SetParameterName("yes/no",false);
+    this->deduplicateCmd->AvailableForStates(G4State_PreInit);
+    this->deduplicateCmd->SetToBeBroadcasted(false);
+
+    this->decimationCmd = new G4UIcmdWithADoubleAndUnit("/geometry/gdml/decimation",this);
+    this->decimationCmd->SetGuidance("simplifies the tessellated meshes of plastic and titanium parts, keeping the surface within the given distance of the original. Glass, gel and PMT stay untouched. 0 to disable.");
+    this->decimationCmd->SetParameterName("deviation",false);
+    this->decimationCmd->SetRange("deviation >= 0");
+    this->decimationCmd->SetDefaultUnit("mm");
+    this->decimationCmd->AvailableForStates(G4State_PreInit);
+    this->decimationCmd->SetToBeBroadcasted(false);
+
+    this->primitivesCmd = new G4UIcmdWithADoubleAndUnit("/geometry/gdml/primitives",this);
+    this->primitivesCmd->SetGuidance("replaces tessellated meshes by a fitted sphere, tube, cone or ellipsoid if all vertices and facet centres are within the given distance of its surface. 0 to disable.");
+    this->primitivesCmd->SetParameterName("tolerance",false);
+    this->primitivesCmd->SetRange("tolerance >= 0");
+    this->primitivesCmd->SetDefaultUnit("mm");
+    this->primitivesCmd->AvailableForStates(G4State_PreInit);
+    this->primitivesCmd->SetToBeBroadcasted(false);
+
     this->submergeCmd = new G4UIcmdWithABool("/geometry/gdml/submerge",this);
     this->submergeCmd->SetGuidance("places water around the imported detector geometry. Air inside the detector will remain.");
     this->submergeCmd->SetParameterName("yes/no",false);
     this->submergeCmd->AvailableForStates(G4State_PreInit);
     this->submergeCmd->SetToBeBroadcasted(false);
 
+    this->submergeModeCmd = new G4UIcmdWithAString("/geometry/gdml/submergeMode",this);
+    this->submergeModeCmd->SetGuidance("boolean: water volume with the inside of the module subtracted, only for the geometries implemented in OMConstruction::submerge().");
+    this->submergeModeCmd->SetGuidance("hull: water as world/envelope material, the air inside the convex hull of the glass housing as volume containing all inner parts. Needs tessellated glass and no parts crossing the hull, falls back to boolean otherwise.");
+    this->submergeModeCmd->SetParameterName("mode",false);
+    this->submergeModeCmd->SetCandidates("boolean hull");
+    this->submergeModeCmd->AvailableForStates(G4State_PreInit);
+    this->submergeModeCmd->SetToBeBroadcasted(false);
+
+    this->envelopeCmd = new G4UIcmdWithABool("/geometry/gdml/envelope",this);
+    this->envelopeCmd->SetGuidance("places the imported geometry, gelpads and PMTs in a tight sphere or tube instead of directly in the world volume.");
+    this->envelopeCmd->SetParameterName("yes/no",false);
+    this->envelopeCmd->AvailableForStates(G4State_PreInit);
+    this->envelopeCmd->SetToBeBroadcasted(false);
+
     this->solidReflectorCmd = new G4UIcmdWithABool("/geometry/gdml/solidReflector",this);
     this->solidReflectorCmd->SetGuidance("Places a solid reflector around the Gelpad edge. Same properties as the PMT reflector.");
     this->solidReflectorCmd->SetParameterName("yes/no",false);
@@ -77,21 +130,95 @@ OMConstructionMessenger::OMConstructionMessenger(OMConstruction* Constr)
     this->PhotocathodeTubeCmd->AvailableForStates(G4State_PreInit);
     this->PhotocathodeTubeCmd->SetDefaultValue(0);
     this->PhotocathodeTubeCmd->SetToBeBroadcasted(false);
+
+    this->QEWeightingCmd = new G4UIcmdWithABool("/geometry/PMT/QEWeighting", this);
+    this->QEWeightingCmd->SetGuidance("detects every photon entering the photocathode, weighted with the quantum efficiency (photoQE in optical_properties.cfg)");
+    this->QEWeightingCmd->SetGuidance("this is a different detector response than the default absorption in the photocathode (photoAbsorption, ~25 % flat),");
+    this->QEWeightingCmd->SetGuidance("results of QE weighted runs are not comparable to runs without QE weighting.");
+    this->QEWeightingCmd->SetParameterName("yes/no",false);
+    this->QEWeightingCmd->AvailableForStates(G4State_PreInit);
+    this->QEWeightingCmd->SetToBeBroadcasted(false);
+
+    this->sharedGelpadsCmd = new G4UIcmdWithADoubleAndUnit("/geometry/PMT/sharedGelpads", this);
+    this->sharedGelpadsCmd->SetGuidance("cuts the gelpads by a sphere fitted to the glass instead of the glass itself, if it deviates less than the given distance.");
+    this->sharedGelpadsCmd->SetGuidance("optical units with the same curvature share one gelpad volume. 0 to disable.");
+    this->sharedGelpadsCmd->SetParameterName("tolerance",false);
+    this->sharedGelpadsCmd->SetRange("tolerance >= 0");
+    this->sharedGelpadsCmd->SetDefaultUnit("mm");
+    this->sharedGelpadsCmd->AvailableForStates(G4State_PreInit);
+    this->sharedGelpadsCmd->SetToBeBroadcasted(false);
+
+    this->flattenPMTCmd = new G4UIcmdWithABool("/geometry/PMT/flatten", this);
+    this->flattenPMTCmd->SetGuidance("places the photocathode directly in the PMT instead of inside the vacuum volumes (one level less in the volume hierarchy)");
+    this->flattenPMTCmd->SetParameterName("yes/no",false);
+    this->flattenPMTCmd->AvailableForStates(G4State_PreInit);
+    this->flattenPMTCmd->SetToBeBroadcasted(false);
+
+    this->fastPMTCmd = new G4UIcmdWithAString("/geometry/PMT/fastModel", this);
+    this->fastPMTCmd->SetGuidance("off: photons are tracked through the PMTs.");
+    this->fastPMTCmd->SetGuidance("generate: photons are tracked through the PMTs, their response is written to the response table at the end of each run.");
+    this->fastPMTCmd->SetGuidance("fast: photons entering a PMT are killed, detection, delay and position are sampled from the response table.");
+    this->fastPMTCmd->SetParameterName("mode",false);
+    this->fastPMTCmd->SetCandidates("off generate fast");
+    this->fastPMTCmd->AvailableForStates(G4State_PreInit);
+    this->fastPMTCmd->SetToBeBroadcasted(false);
+
+    this->PMTResponseCmd = new G4UIcmdWithAString("/geometry/PMT/responseTable", this);
+    this->PMTResponseCmd->SetGuidance("file of the PMT response table of the fast PMT model");
+    this->PMTResponseCmd->SetParameterName("file",false);
+    this->PMTResponseCmd->AvailableForStates(G4State_PreInit);
+    this->PMTResponseCmd->SetToBeBroadcasted(false);
+
+    this->navigationFileCmd = new G4UIcmdWithAString("/geometry/navigation/file", this);
+    this->navigationFileCmd->SetGuidance("file with the tuned smartless and voxel settings, applied after the construction. Empty to keep the Geant4 defaults.");
+    this->navigationFileCmd->SetParameterName("file",true);
+    this->navigationFileCmd->SetDefaultValue("");
+    this->navigationFileCmd->AvailableForStates(G4State_PreInit);
+    this->navigationFileCmd->SetToBeBroadcasted(false);
+
+    this->navigationTuneCmd = new G4UIcmdWithABool("/geometry/navigation/tune", this);
+    this->navigationTuneCmd->SetGuidance("benchmarks the smartless settings of world, envelope and large mothers and the voxel limits of the largest meshes, writes the fastest to the navigation file");
+    this->navigationTuneCmd->SetParameterName("yes/no",false);
+    this->navigationTuneCmd->AvailableForStates(G4State_PreInit);
+    this->navigationTuneCmd->SetToBeBroadcasted(false);
+
+    this->navigationRaysCmd = new G4UIcmdWithAnInteger("/geometry/navigation/rays", this);
+    this->navigationRaysCmd->SetGuidance("number of rays traced through the geometry per timed setting");
+    this->navigationRaysCmd->SetParameterName("rays",false);
+    this->navigationRaysCmd->SetRange("rays > 0");
+    this->navigationRaysCmd->AvailableForStates(G4State_PreInit);
+    this->navigationRaysCmd->SetToBeBroadcasted(false);
 }
 
 OMConstructionMessenger::~OMConstructionMessenger()
 {
     delete this->GDMLDir;
     delete this->OpticalUnitDir;
+    delete this->NavigationDir;
     delete this->submergeCmd;
+    delete this->envelopeCmd;
+    delete this->submergeModeCmd;
     delete this->solidReflectorCmd;
     delete this->gdmlfileCmd;
+    delete this->gdmlCacheCmd;
+    delete this->gdmlThreadsCmd;
+    delete this->deduplicateCmd;
+    delete this->decimationCmd;
+    delete this->primitivesCmd;
     delete this->OUOrgCmd;
     delete this->OURefXCmd;
     delete this->OURefYCmd;
     delete this->OUPlaceCmd;
     delete this->GelRingCmd;
     delete this->PhotocathodeTubeCmd;
+    delete this->QEWeightingCmd;
+    delete this->sharedGelpadsCmd;
+    delete this->flattenPMTCmd;
+    delete this->fastPMTCmd;
+    delete this->PMTResponseCmd;
+    delete this->navigationFileCmd;
+    delete this->navigationTuneCmd;
+    delete this->navigationRaysCmd;
 }
 
 void OMConstructionMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
@@ -102,12 +229,54 @@ void OMConstructionMessenger::SetNewValue(G4UIcommand* command,G4String newValue
         this->_Construction->setGDMLFilename(newValue);
     }
 
+    // Set gdml cache directory
+    if( command == this->gdmlCacheCmd )
+    {
+        this->_Construction->setGDMLCacheDirectory(newValue);
+    }
+
+    // Set gdml reader threads
+    if( command == this->gdmlThreadsCmd )
+    {
+        this->_Construction->setGDMLThreads(this->gdmlThreadsCmd->GetNewIntValue(newValue));
+    }
+
+    // set mesh deduplication
+    if ( command == this->deduplicateCmd )
+    {
+        this->_Construction->setDeduplicate(this->deduplicateCmd->GetNewBoolValue(newValue));
+    }
+
+    // set mesh decimation
+    if ( command == this->decimationCmd )
+    {
+        this->_Construction->setDecimationTolerance(this->decimationCmd->GetNewDoubleValue(newValue));
+    }
+
+    // set primitive fitting
+    if ( command == this->primitivesCmd )
+    {
+        this->_Construction->setPrimitiveTolerance(this->primitivesCmd->GetNewDoubleValue(newValue));
+    }
+
     // set submerge
     if ( command == this->submergeCmd )
     {
         this->_Construction->setSubmerge(this->submergeCmd->GetNewBoolValue(newValue));
     }
 
+    // set submerge mode
+    if ( command == this->submergeModeCmd )
+    {
+        this->_Construction->setSubmergeMode(newValue);
+    }
+
+    // set envelope
+    if ( command == this->envelopeCmd )
+    {
+        this->_Construction->setEnvelope(this->envelopeCmd->GetNewBoolValue(newValue));
+    }
+
     // set solid reflector
     if ( command == this->solidReflectorCmd )
     {
@@ -154,4 +323,50 @@ void OMConstructionMessenger::SetNewValue(G4UIcommand* command,G4String newValue
         this->_Construction->setPhotocathodeTubeLength(this->PhotocathodeTubeCmd->GetNewDoubleValue(newValue));
     }
 
+    // Set QE weighting
+    if( command == this->QEWeightingCmd )
+    {
+        this->_Construction->setQEWeighting(this->QEWeightingCmd->GetNewBoolValue(newValue));
+    }
+
+    // set shared gelpads
+    if( command == this->sharedGelpadsCmd )
+    {
+        this->_Construction->setGelpadTolerance(this->sharedGelpadsCmd->GetNewDoubleValue(newValue));
+    }
+
+    // set flattened PMT
+    if( command == this->flattenPMTCmd )
+    {
+        this->_Construction->setFlattenPMT(this->flattenPMTCmd->GetNewBoolValue(newValue));
+    }
+
+    // set fast PMT model
+    if( command == this->fastPMTCmd )
+    {
+        this->_Construction->setFastPMTMode(newValue);
+    }
+
+    // set PMT response table
+    if( command == this->PMTResponseCmd )
+    {
+        this->_Construction->setPMTResponseFile(newValue);
+    }
+
+    // set navigation tuning
+    if( command == this->navigationFileCmd )
+    {
+        this->_Construction->setNavigationFile(newValue);
+    }
+
+    if( command == this->navigationTuneCmd )
+    {
+        this->_Construction->setNavigationTuning(this->navigationTuneCmd->GetNewBoolValue(newValue));
+    }
+
+    if( command == this->navigationRaysCmd )
+    {
+        this->_Construction->setNavigationRays(this->navigationRaysCmd->GetNewIntValue(newValue));
+    }
+
 }
\ No newline at end of file
@@ -1,8 +1,12 @@
 // system includes
 #include <filesystem>
+#include <algorithm>
+#include <map>
 
 // G4 includes
 #include "G4Exception.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
 
 // project includes
 #include "OMDataManager.hh"
@@ -27,6 +31,21 @@ OMDataManager::OMDataManager()
  _filter_outVolume(""),
  _filter_data_glass(false),
  _filter_photons(false),
+ _hits_output(false),
+ _trigger_enabled(false),
+ _trigger_multiplicity(2),
+ _trigger_window(20 * ns),
+ _record_path_lengths(false),
+ _phasespace_filename(""),
+ _phasespace_radius(40 * cm),
+ _phasespace_centre(0),
+ _phasespace_kill(true),
+ _current_phasespace_recorded(false),
+ _current_fast_pmt_channel(-1),
+ _nr_of_events(0),
+ _nr_of_triggered_events(0),
+ _nr_of_steps(0),
+ _nr_of_tracks(0),
  _current_pid(0),
  _current_in_time(0),
  _current_in_position(0),
@@ -43,6 +62,7 @@ OMDataManager::OMDataManager()
  _current_out_volume_copyno(0),
  _current_out_process_name("")
 {
+    this->resetPathLengths();
     this->_DataManagerMessenger = new OMDataManagerMessenger(this);
 }
 
@@ -83,13 +103,166 @@ void OMDataManager::open()
         std::remove(this->_filename);
     }
 
+    this->buildMaterialTable();
+
+    this->_nr_of_events           = 0;
+    this->_nr_of_triggered_events = 0;
+    this->_nr_of_steps            = 0;
+    this->_nr_of_tracks           = 0;
+    this->_multiplicity_counts.clear();
+
     this->_file_is_open = true;
     this->_File = std::ofstream(this->_filename);
-    this->_File << "PID,in_t,in_x,in_y,in_z,in_E,in_px,in_py,in_pz,g_x,g_y,g_z,g_px,g_py,g_pz,out_t,out_x,out_y,out_z,out_E,out_px,out_py,out_pz,out_VolumeName,out_Volume_CopyNo,out_ProcessName" << std::endl;
+    if (this->_hits_output) this->_File << "event,channel,t,x,y,z,px,py,pz,wavelength,angle,weight";
+    else                    this->_File << "PID,in_t,in_x,in_y,in_z,in_E,in_px,in_py,in_pz,g_x,g_y,g_z,g_px,g_py,g_pz,out_t,out_x,out_y,out_z,out_E,out_px,out_py,out_pz,out_VolumeName,out_Volume_CopyNo,out_ProcessName";
+    if (this->_record_path_lengths) this->_File << ",l_water,l_glass,l_gel,l_vacuum";
+    this->_File << std::endl;
+
+    // phase space recording (mm, ns, eV)
+    if (this->_phasespace_filename != "")
+    {
+        G4double centre[3] = {this->_phasespace_centre[0] / mm, this->_phasespace_centre[1] / mm, this->_phasespace_centre[2] / mm};
+        if (!this->_phasespace_writer.open(this->_phasespace_filename, this->_phasespace_radius / mm, centre))
+        {
+            G4Exception("OMDataManager::open()",
+                        "can not open phase space file",
+                        JustWarning,
+                        "the DataManager could not open the phase space file. No phase space will be recorded!");
+        }
+    }
 }
 
 void OMDataManager::close()
 {
     this->_File.close();
     this->_file_is_open = false;
+
+    if (this->_phasespace_writer.isOpen())
+    {
+        G4cout << ">> " << this->_phasespace_writer.getNrOfRecords() << " photons recorded to phase space file " << this->_phasespace_filename << G4endl;
+        this->_phasespace_writer.close();
+    }
+}
+
+void OMDataManager::buildMaterialTable()
+{
+    // lookup table from material index to path length slot, so the stepping action does not need any string comparison
+    // names as given in OMMaterialManager
+    const G4String slot_materials[OMPhotocathodeHit::nr_of_path_materials] = {"G4_WATER", "G4_Pyrex_Glass", "OpticalGel", "G4_Galactic"};
+
+    this->_material_slot.assign(G4Material::GetNumberOfMaterials(), -1);
+    for (G4int i = 0; i < OMPhotocathodeHit::nr_of_path_materials; i++)
+    {
+        G4Material* material = G4Material::GetMaterial(slot_materials[i], false);
+        if (material != nullptr) this->_material_slot[material->GetIndex()] = i;
+    }
+}
+
+void OMDataManager::beginEvent()
+{
+    this->_event_buffer.str("");
+    this->_event_buffer.clear();
+    this->_event_hits.clear();
+}
+
+void OMDataManager::endEvent(G4int event_id, OMPhotocathodeHitsCollection* hits)
+{
+    this->_nr_of_events++;
+
+    // trigger works on the photocathode hits only
+    size_t nr_of_hits = (hits == nullptr) ? 0 : hits->GetSize();
+    for (size_t i = 0; i < nr_of_hits; i++)
+    {
+        this->_event_hits.push_back(std::make_pair((*hits)[i]->getTime(), (*hits)[i]->getChannel()));
+    }
+
+    G4int multiplicity = this->getEventMultiplicity();
+    if (multiplicity >= (G4int) this->_multiplicity_counts.size()) this->_multiplicity_counts.resize(multiplicity + 1, 0);
+    this->_multiplicity_counts[multiplicity]++;
+
+    G4bool triggered = multiplicity >= this->_trigger_multiplicity;
+    if (triggered) this->_nr_of_triggered_events++;
+
+    // only triggered events make it into the output file
+    G4bool do_write = this->_file_is_open && (triggered || !this->_trigger_enabled);
+
+    if (this->_hits_output && do_write)
+    {
+        for (size_t i = 0; i < nr_of_hits; i++)
+        {
+            const OMPhotocathodeHit* hit = (*hits)[i];
+            this->_File << event_id                  << ","
+                        << hit->getChannel()         << ","
+                        << hit->getTime()            << ","
+                        << hit->getPosition()[0]     << ","
+                        << hit->getPosition()[1]     << ","
+                        << hit->getPosition()[2]     << ","
+                        << hit->getDirection()[0]    << ","
+                        << hit->getDirection()[1]    << ","
+                        << hit->getDirection()[2]    << ","
+                        << hit->getWavelength()      << ","
+                        << hit->getIncidenceAngle()  << ","
+                        << hit->getWeight();
+            if (this->_record_path_lengths)
+            {
+                for (G4int j = 0; j < OMPhotocathodeHit::nr_of_path_materials; j++) this->_File << "," << hit->getPathLengths()[j];
+            }
+            this->_File << "\n";
+        }
+    }
+
+    // track records were written directly if no trigger is active
+    else if (this->_trigger_enabled && do_write)
+    {
+        this->_File << this->_event_buffer.str();
+    }
+
+    this->_event_buffer.str("");
+    this->_event_buffer.clear();
+    this->_event_hits.clear();
+}
+
+G4int OMDataManager::getEventMultiplicity()
+{
+    // maximum number of different PMTs hit within any time window of the set length
+    if (this->_event_hits.empty()) return 0;
+
+    std::sort(this->_event_hits.begin(), this->_event_hits.end());
+
+    G4int max_multiplicity = 0;
+    std::map<G4int,G4int> hits_per_pmt;
+    size_t window_start = 0;
+
+    for (size_t i = 0; i < this->_event_hits.size(); i++)
+    {
+        hits_per_pmt[this->_event_hits[i].second]++;
+
+        while (this->_event_hits[i].first - this->_event_hits[window_start].first > this->_trigger_window)
+        {
+            G4int pmt = this->_event_hits[window_start].second;
+            if (--hits_per_pmt[pmt] == 0) hits_per_pmt.erase(pmt);
+            window_start++;
+        }
+        max_multiplicity = std::max(max_multiplicity, (G4int) hits_per_pmt.size());
+    }
+    return max_multiplicity;
+}
+
+void OMDataManager::printTriggerSummary()
+{
+    G4cout << ">> trigger: " << this->_trigger_multiplicity << " PMTs within " << this->_trigger_window / ns << " ns"
+           << (this->_trigger_enabled ? "" : " (not applied to output)") << G4endl;
+    G4cout << ">> triggered events: " << this->_nr_of_triggered_events << " / " << this->_nr_of_events;
+    if (this->_nr_of_events > 0) G4cout << " (efficiency " << (G4double) this->_nr_of_triggered_events / this->_nr_of_events << ")";
+    G4cout << G4endl;
+
+    // fraction of events that would pass a trigger of multiplicity >= n
+    G4int events_above = this->_nr_of_events;
+    for (size_t n = 1; n < this->_multiplicity_counts.size(); n++)
+    {
+        events_above -= this->_multiplicity_counts[n-1];
+        G4cout << ">>   multiplicity >= " << n << ": " << events_above << " events";
+        if (this->_nr_of_events > 0) G4cout << " (" << (G4double) events_above / this->_nr_of_events << ")";
+        G4cout << G4endl;
+    }
 }
\ No newline at end of file
@@ -20,6 +20,13 @@ OMDataManagerMessenger::OMDataManagerMessenger(OMDataManager* Constr)
     this->_outputFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
     this->_outputFileCmd->SetToBeBroadcasted(false);
 
+    this->_outputModeCmd = new G4UIcmdWithAString("/daq/output_mode",this);
+    this->_outputModeCmd->SetGuidance("Write one record per track (tracks) or one record per photocathode hit (hits).");
+    this->_outputModeCmd->SetParameterName("mode",false);
+    this->_outputModeCmd->SetCandidates("tracks hits");
+    this->_outputModeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_outputModeCmd->SetToBeBroadcasted(false);
+
     this->_dataFilterOutProcessCmd = new G4UIcmdWithAString("/daq/outProcess_filter",this);
     this->_dataFilterOutProcessCmd->SetGuidance("Filters data if the outProcess is part of the given string.");
     this->_dataFilterOutProcessCmd->SetParameterName("processes",false);
@@ -43,15 +50,86 @@ OMDataManagerMessenger::OMDataManagerMessenger(OMDataManager* Constr)
     this->_dataFilterPhotonsCmd->SetParameterName("yes/no",false);
     this->_dataFilterPhotonsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
     this->_dataFilterPhotonsCmd->SetToBeBroadcasted(false);
+
+    this->_pathLengthsCmd = new G4UIcmdWithABool("/daq/path_lengths",this);
+    this->_pathLengthsCmd->SetGuidance("Determines if the path length in water, glass, gel and vacuum is recorded for each track/hit.");
+    this->_pathLengthsCmd->SetParameterName("yes/no",false);
+    this->_pathLengthsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_pathLengthsCmd->SetToBeBroadcasted(false);
+
+    this->_triggerDir = new G4UIdirectory("/daq/trigger/");
+    this->_triggerDir->SetGuidance("local coincidence trigger evaluated at the end of each event");
+
+    this->_triggerEnableCmd = new G4UIcmdWithABool("/daq/trigger/enable",this);
+    this->_triggerEnableCmd->SetGuidance("Determines if only events passing the trigger are written to file.");
+    this->_triggerEnableCmd->SetParameterName("yes/no",false);
+    this->_triggerEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_triggerEnableCmd->SetToBeBroadcasted(false);
+
+    this->_triggerMultiplicityCmd = new G4UIcmdWithAnInteger("/daq/trigger/multiplicity",this);
+    this->_triggerMultiplicityCmd->SetGuidance("Minimum number of different PMTs hit within the trigger window.");
+    this->_triggerMultiplicityCmd->SetParameterName("multiplicity",false);
+    this->_triggerMultiplicityCmd->SetRange("multiplicity >= 1");
+    this->_triggerMultiplicityCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_triggerMultiplicityCmd->SetToBeBroadcasted(false);
+
+    this->_triggerWindowCmd = new G4UIcmdWithADoubleAndUnit("/daq/trigger/window",this);
+    this->_triggerWindowCmd->SetGuidance("Length of the time window the PMT hits have to fall into.");
+    this->_triggerWindowCmd->SetParameterName("window",false);
+    this->_triggerWindowCmd->SetDefaultUnit("ns");
+    this->_triggerWindowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_triggerWindowCmd->SetToBeBroadcasted(false);
+
+    this->_phaseSpaceDir = new G4UIdirectory("/daq/phasespace/");
+    this->_phaseSpaceDir->SetGuidance("recording of optical photons entering a sphere around the module");
+
+    this->_phaseSpaceFileCmd = new G4UIcmdWithAString("/daq/phasespace/file",this);
+    this->_phaseSpaceFileCmd->SetGuidance("Set the binary phase space file to record into. An empty string disables the recording.");
+    this->_phaseSpaceFileCmd->SetParameterName("filename",true);
+    this->_phaseSpaceFileCmd->SetDefaultValue("");
+    this->_phaseSpaceFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_phaseSpaceFileCmd->SetToBeBroadcasted(false);
+
+    this->_phaseSpaceRadiusCmd = new G4UIcmdWithADoubleAndUnit("/daq/phasespace/radius",this);
+    this->_phaseSpaceRadiusCmd->SetGuidance("Radius of the recording sphere, has to enclose the module.");
+    this->_phaseSpaceRadiusCmd->SetParameterName("radius",false);
+    this->_phaseSpaceRadiusCmd->SetRange("radius > 0");
+    this->_phaseSpaceRadiusCmd->SetDefaultUnit("cm");
+    this->_phaseSpaceRadiusCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_phaseSpaceRadiusCmd->SetToBeBroadcasted(false);
+
+    this->_phaseSpaceCentreCmd = new G4UIcmdWith3VectorAndUnit("/daq/phasespace/centre",this);
+    this->_phaseSpaceCentreCmd->SetGuidance("Centre of the recording sphere.");
+    this->_phaseSpaceCentreCmd->SetParameterName("x","y","z",false);
+    this->_phaseSpaceCentreCmd->SetDefaultUnit("cm");
+    this->_phaseSpaceCentreCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_phaseSpaceCentreCmd->SetToBeBroadcasted(false);
+
+    this->_phaseSpaceKillCmd = new G4UIcmdWithABool("/daq/phasespace/kill",this);
+    this->_phaseSpaceKillCmd->SetGuidance("Determines if recorded photons are killed instead of tracked through the module.");
+    this->_phaseSpaceKillCmd->SetParameterName("yes/no",false);
+    this->_phaseSpaceKillCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_phaseSpaceKillCmd->SetToBeBroadcasted(false);
 }
 
 OMDataManagerMessenger::~OMDataManagerMessenger()
 {
     delete this->_outputFileCmd;
+    delete this->_outputModeCmd;
     delete this->_dataFilterOutProcessCmd;
     delete this->_dataFilterOutVolumeCmd;
     delete this->_dataFilterGlassCmd;
     delete this->_dataFilterPhotonsCmd;
+    delete this->_pathLengthsCmd;
+    delete this->_triggerEnableCmd;
+    delete this->_triggerMultiplicityCmd;
+    delete this->_triggerWindowCmd;
+    delete this->_triggerDir;
+    delete this->_phaseSpaceFileCmd;
+    delete this->_phaseSpaceRadiusCmd;
+    delete this->_phaseSpaceCentreCmd;
+    delete this->_phaseSpaceKillCmd;
+    delete this->_phaseSpaceDir;
 }
 
 void OMDataManagerMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
@@ -62,6 +140,12 @@ void OMDataManagerMessenger::SetNewValue(G4UIcommand* command, G4String newValue
         this->_DataManager->setFilename(newValue);
     }
 
+    // Set output mode
+    if( command == this->_outputModeCmd)
+    {
+        this->_DataManager->setOutputMode(newValue);
+    }
+
     // Set outProcess filter
     if( command == this->_dataFilterOutProcessCmd)
     {
@@ -85,4 +169,52 @@ void OMDataManagerMessenger::SetNewValue(G4UIcommand* command, G4String newValue
     {
         this->_DataManager->setPhotonsFilter(this->_dataFilterPhotonsCmd->GetNewBoolValue(newValue));
     }
+
+    // Set path length recording
+    if ( command == this->_pathLengthsCmd )
+    {
+        this->_DataManager->setRecordPathLengths(this->_pathLengthsCmd->GetNewBoolValue(newValue));
+    }
+
+    // Set trigger
+    if ( command == this->_triggerEnableCmd )
+    {
+        this->_DataManager->setTriggerEnabled(this->_triggerEnableCmd->GetNewBoolValue(newValue));
+    }
+
+    // Set trigger multiplicity
+    if ( command == this->_triggerMultiplicityCmd )
+    {
+        this->_DataManager->setTriggerMultiplicity(this->_triggerMultiplicityCmd->GetNewIntValue(newValue));
+    }
+
+    // Set trigger window
+    if ( command == this->_triggerWindowCmd )
+    {
+        this->_DataManager->setTriggerWindow(this->_triggerWindowCmd->GetNewDoubleValue(newValue));
+    }
+
+    // Set phase space file
+    if ( command == this->_phaseSpaceFileCmd )
+    {
+        this->_DataManager->setPhaseSpaceFilename(newValue);
+    }
+
+    // Set phase space sphere radius
+    if ( command == this->_phaseSpaceRadiusCmd )
+    {
+        this->_DataManager->setPhaseSpaceRadius(this->_phaseSpaceRadiusCmd->GetNewDoubleValue(newValue));
+    }
+
+    // Set phase space sphere centre
+    if ( command == this->_phaseSpaceCentreCmd )
+    {
+        this->_DataManager->setPhaseSpaceCentre(this->_phaseSpaceCentreCmd->GetNew3VectorValue(newValue));
+    }
+
+    // Set phase space kill
+    if ( command == this->_phaseSpaceKillCmd )
+    {
+        this->_DataManager->setPhaseSpaceKill(this->_phaseSpaceKillCmd->GetNewBoolValue(newValue));
+    }
 }
\ No newline at end of file
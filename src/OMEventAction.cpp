@@ -0,0 +1,46 @@
+// system includes
+
+// G4 includes
+#include "G4SDManager.hh"
+#include "G4HCofThisEvent.hh"
+
+// project includes
+#include "OMEventAction.hh"
+#include "OMDataManager.hh"
+#include "OMPhotocathodeHit.hh"
+#include "OMProfiler.hh"
+
+OMEventAction::OMEventAction()
+: _photocathode_hc_id(-1)
+{
+}
+
+OMEventAction::~OMEventAction()
+{
+    // TODO
+}
+
+void OMEventAction::BeginOfEventAction(const G4Event*)
+{
+    OMDataManager::getInstance()->beginEvent();
+}
+
+void OMEventAction::EndOfEventAction(const G4Event* event)
+{
+    // hits collection only exists if PMTs are placed
+    if (this->_photocathode_hc_id < 0 && G4SDManager::GetSDMpointer()->FindSensitiveDetector("photocathodeSD", false) != nullptr)
+    {
+        this->_photocathode_hc_id = G4SDManager::GetSDMpointer()->GetCollectionID("photocathodeSD/photocathodeHits");
+    }
+
+    OMPhotocathodeHitsCollection* hits = nullptr;
+    if (this->_photocathode_hc_id >= 0 && event->GetHCofThisEvent() != nullptr)
+    {
+        hits = static_cast<OMPhotocathodeHitsCollection*>(event->GetHCofThisEvent()->GetHC(this->_photocathode_hc_id));
+    }
+
+    // trigger decision and (buffered) output of the event
+    OMDataManager::getInstance()->endEvent(event->GetEventID(), hits);
+
+    OMProfiler::getInstance()->endEvent();
+}
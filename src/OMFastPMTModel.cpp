@@ -0,0 +1,87 @@
+// system includes
+
+// G4 includes
+#include "G4OpticalPhoton.hh"
+#include "G4SDManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+
+// project includes
+#include "OMFastPMTModel.hh"
+#include "OMPMTResponse.hh"
+#include "OMPhotocathodeSD.hh"
+#include "OMDataManager.hh"
+
+
+OMFastPMTModel::OMFastPMTModel(G4String name, G4Region* envelope, G4bool generate)
+: G4VFastSimulationModel(name, envelope),
+ _generate(generate)
+{
+    this->_photocathode_sd = static_cast<OMPhotocathodeSD*>(G4SDManager::GetSDMpointer()->FindSensitiveDetector("photocathodeSD"));
+}
+
+OMFastPMTModel::~OMFastPMTModel()
+{
+}
+
+G4bool OMFastPMTModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+    return &particle == G4OpticalPhoton::Definition();
+}
+
+G4bool OMFastPMTModel::ModelTrigger(const G4FastTrack& fast_track)
+{
+    // the trigger is asked in every step inside the PMT, only photons that just entered it from outside are handled
+    const G4Track* track = fast_track.GetPrimaryTrack();
+    const G4Step*  step  = track->GetStep();
+    if (track->GetCurrentStepNumber() == 0 || step == nullptr) return false;
+    if (step->GetPostStepPoint()->GetStepStatus() != fGeomBoundary) return false;
+
+    const G4VPhysicalVolume* previous = step->GetPreStepPoint()->GetPhysicalVolume();
+    if (previous != nullptr && previous->GetLogicalVolume()->GetRegion() == fast_track.GetEnvelope()) return false;
+
+    if (!this->_generate) return true;
+
+    // generation: the detailed model continues, the photocathode sensitive detector reports the detection
+    OMPMTResponse::getInstance()->recordEntry(track->GetTrackID(), this->getBin(fast_track), track->GetGlobalTime(), *fast_track.GetAffineTransformation());
+    return false;
+}
+
+void OMFastPMTModel::DoIt(const G4FastTrack& fast_track, G4FastStep& fast_step)
+{
+    const G4Track*             track  = fast_track.GetPrimaryTrack();
+    const OMPMTResponseSample* sample = OMPMTResponse::getInstance()->sample(this->getBin(fast_track));
+
+    fast_step.KillPrimaryTrack();
+    fast_step.ProposePrimaryTrackPathLength(0);
+    if (sample == nullptr) return;
+
+    G4ThreeVector local_position(sample->position[0] * mm, sample->position[1] * mm, sample->position[2] * mm);
+    G4double      time    = track->GetGlobalTime() + sample->delay * ns;
+    G4int         channel = fast_track.GetEnvelopePhysicalVolume()->GetCopyNo();
+
+    fast_step.ProposePrimaryTrackFinalPosition(local_position);
+    fast_step.ProposePrimaryTrackFinalTime(time);
+
+    // tracks output: the record of the track ends on the photocathode of this PMT
+    OMDataManager::getInstance()->setFastPMTChannel(channel);
+
+    OMPhotocathodeHit* hit = new OMPhotocathodeHit();
+    hit->setChannel(channel);
+    hit->setTime(time);
+    hit->setPosition(fast_track.GetInverseAffineTransformation()->TransformPoint(local_position) / mm);
+    hit->setDirection(track->GetMomentumDirection());
+    hit->setWavelength(h_Planck * c_light / track->GetTotalEnergy() / nm);
+    hit->setIncidenceAngle(sample->angle);
+    hit->setWeight(track->GetWeight() * sample->weight);
+    hit->setPathLengths(OMDataManager::getInstance()->getPathLengths());
+    this->_photocathode_sd->addHit(hit);
+}
+
+G4int OMFastPMTModel::getBin(const G4FastTrack& fast_track)
+{
+    G4ThreeVector position = fast_track.GetPrimaryTrackLocalPosition();
+    G4ThreeVector normal   = fast_track.GetEnvelopeSolid()->SurfaceNormal(position);
+
+    return OMPMTResponse::getInstance()->getBin(position, fast_track.GetPrimaryTrackLocalDirection(), normal, fast_track.GetPrimaryTrack()->GetTotalEnergy());
+}
\ No newline at end of file
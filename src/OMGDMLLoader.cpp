@@ -0,0 +1,504 @@
+// system includes
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+// G4 includes
+#include "G4SystemOfUnits.hh"
+#include "G4GeometryTolerance.hh"
+#include "G4Box.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4TriangularFacet.hh"
+#include "G4QuadrangularFacet.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PVPlacement.hh"
+
+// project includes
+#include "OMGDMLLoader.hh"
+
+
+//-----------
+// minimal xml tag reader, sufficient for the machine written GDML files
+//-----------
+
+struct OMXMLTag
+{
+    std::string                                       name;
+    std::vector<std::pair<std::string, std::string>>  attributes;
+    G4bool                                            closing;        // </tag>
+    G4bool                                            self_closing;   // <tag/>
+
+    const std::string* get(const char* key) const
+    {
+        for (const auto& attribute : this->attributes) if (attribute.first == key) return &attribute.second;
+        return nullptr;
+    }
+};
+
+// reads the next element tag, skips declarations and comments. returns false at the end of the text or on malformed input
+static G4bool nextTag(const std::string& text, size_t& pos, OMXMLTag& tag, G4bool& error)
+{
+    while (true)
+    {
+        pos = text.find('<', pos);
+        if (pos == std::string::npos || pos + 1 >= text.size()) return false;
+
+        if (text.compare(pos, 4, "<!--") == 0)
+        {
+            pos = text.find("-->", pos);
+            if (pos == std::string::npos) {error = true; return false;}
+            pos += 3;
+        }
+        else if (text[pos + 1] == '?' || text[pos + 1] == '!')
+        {
+            pos = text.find('>', pos);
+            if (pos == std::string::npos) {error = true; return false;}
+            pos += 1;
+        }
+        else break;
+    }
+
+    size_t end = text.find('>', pos);
+    if (end == std::string::npos) {error = true; return false;}
+
+    size_t i = pos + 1;
+    tag.closing      = text[i] == '/';
+    tag.self_closing = text[end - 1] == '/';
+    if (tag.closing) i++;
+    size_t content_end = tag.self_closing ? end - 1 : end;
+
+    size_t name_end = i;
+    while (name_end < content_end && !std::isspace(static_cast<unsigned char>(text[name_end]))) name_end++;
+    tag.name.assign(text, i, name_end - i);
+
+    tag.attributes.clear();
+    for (i = name_end; ; )
+    {
+        while (i < content_end && std::isspace(static_cast<unsigned char>(text[i]))) i++;
+        if (i >= content_end) break;
+
+        size_t equal = text.find('=', i);
+        if (equal == std::string::npos || equal >= content_end) {error = true; return false;}
+        size_t key_end = equal;
+        while (key_end > i && std::isspace(static_cast<unsigned char>(text[key_end - 1]))) key_end--;
+
+        size_t quote = equal + 1;
+        while (quote < content_end && std::isspace(static_cast<unsigned char>(text[quote]))) quote++;
+        if (quote >= content_end || (text[quote] != '"' && text[quote] != '\'')) {error = true; return false;}
+        size_t value_end = text.find(text[quote], quote + 1);
+        if (value_end == std::string::npos || value_end >= content_end) {error = true; return false;}
+
+        tag.attributes.emplace_back(text.substr(i, key_end - i), text.substr(quote + 1, value_end - quote - 1));
+        i = value_end + 1;
+    }
+
+    pos = end + 1;
+    return true;
+}
+
+// plain numbers only, GDML expressions are left to G4GDMLParser
+static G4bool toDouble(const std::string* value, G4double& result, G4double fallback)
+{
+    if (value == nullptr) {result = fallback; return true;}
+    const char* begin = value->c_str();
+    char* end = nullptr;
+    result = std::strtod(begin, &end);
+    while (end != begin && std::isspace(static_cast<unsigned char>(*end))) end++;
+    return end != begin && *end == '\0';
+}
+
+static G4bool toUnit(const std::string* value, G4double& result, G4bool angle)
+{
+    static const std::map<std::string, G4double> length_units = {{"nm", nm}, {"um", um}, {"mm", mm}, {"cm", cm}, {"m", m}, {"km", km}};
+    static const std::map<std::string, G4double> angle_units  = {{"rad", rad}, {"mrad", mrad}, {"deg", deg}, {"degree", degree}};
+
+    const std::map<std::string, G4double>& units = angle ? angle_units : length_units;
+    if (value == nullptr) {result = angle ? rad : mm; return true;}
+    auto found = units.find(*value);
+    if (found == units.end()) return false;
+    result = found->second;
+    return true;
+}
+
+static G4bool toVector(const OMXMLTag& tag, const char* unit_key, G4bool angle, G4ThreeVector& result)
+{
+    G4double unit, x, y, z;
+    if (!toUnit(tag.get(unit_key), unit, angle)) return false;
+    if (!toDouble(tag.get("x"), x, 0) || !toDouble(tag.get("y"), y, 0) || !toDouble(tag.get("z"), z, 0)) return false;
+    result = G4ThreeVector(x, y, z) * unit;
+    return true;
+}
+
+static void runParallel(G4int nr_of_threads, size_t nr_of_jobs, const std::function<void(size_t)>& job)
+{
+    std::atomic<size_t> next(0);
+    auto worker = [&]()
+    {
+        for (size_t i = next++; i < nr_of_jobs; i = next++) job(i);
+    };
+
+    std::vector<std::thread> threads;
+    for (G4int t = 1; t < nr_of_threads && t < (G4int) nr_of_jobs; t++) threads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : threads) thread.join();
+}
+
+
+//-----------
+// one placed part of the mother file
+//-----------
+
+struct OMGDMLVolumeFile
+{
+    G4String                filename;
+    G4String                placement_name;
+    G4ThreeVector           position;
+    G4ThreeVector           rotation;      // GDML angles
+    G4int                   copy_nr;
+
+    // filled by the worker threads
+    G4String                volume_name;
+    G4String                solid_name;
+    G4bool                  is_box;
+    G4ThreeVector           box_half_size;
+    std::vector<G4VFacet*>  facets;
+    G4TessellatedSolid*     solid;
+    G4bool                  ok;
+};
+
+
+OMGDMLLoader::OMGDMLLoader(G4int nr_of_threads)
+: _nr_of_threads(nr_of_threads)
+{
+    if (this->_nr_of_threads <= 0) this->_nr_of_threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+OMGDMLLoader::~OMGDMLLoader()
+{
+    // TODO
+}
+
+G4VPhysicalVolume* OMGDMLLoader::read(const G4String& filename)
+{
+    std::ifstream in(filename);
+    if (!in.is_open()) return nullptr;
+    std::stringstream content;
+    content << in.rdbuf();
+    const std::string text = content.str();
+
+    //-----------
+    // mother file: world box and one file per part
+    //-----------
+
+    std::unordered_map<std::string, G4ThreeVector> positions;
+    std::unordered_map<std::string, G4ThreeVector> rotations;
+
+    std::vector<OMGDMLVolumeFile> files;
+    G4String      world_name  = "";
+    G4String      world_solid = "";
+    G4String      box_name    = "";
+    G4ThreeVector box_half_size;
+    G4String      section     = "";
+    G4int         nr_of_volumes = 0;
+    G4bool        in_physvol  = false;
+
+    OMXMLTag tag;
+    G4bool   error = false;
+    size_t   pos   = 0;
+    while (nextTag(text, pos, tag, error))
+    {
+        if (tag.closing)
+        {
+            if (tag.name == section) section = "";
+            if (tag.name == "physvol") in_physvol = false;
+            continue;
+        }
+
+        if (tag.name == "define" || tag.name == "materials" || tag.name == "solids" || tag.name == "structure" || tag.name == "setup")
+        {
+            if (!tag.self_closing) section = tag.name;
+        }
+        else if (section == "define" && (tag.name == "position" || tag.name == "rotation"))
+        {
+            G4ThreeVector value;
+            if (tag.get("name") == nullptr || !toVector(tag, "unit", tag.name == "rotation", value)) return nullptr;
+            (tag.name == "position" ? positions : rotations)[*tag.get("name")] = value;
+        }
+        else if (section == "define" || section == "materials")
+        {
+            // constants and materials are not needed, the materials are assigned by name afterwards
+            continue;
+        }
+        else if (section == "solids")
+        {
+            G4double lunit, x, y, z;
+            if (tag.name != "box" || !box_name.empty() || tag.get("name") == nullptr) return nullptr;
+            if (!toUnit(tag.get("lunit"), lunit, false) || !toDouble(tag.get("x"), x, 0) || !toDouble(tag.get("y"), y, 0) || !toDouble(tag.get("z"), z, 0)) return nullptr;
+            box_name      = *tag.get("name");
+            box_half_size = G4ThreeVector(x, y, z) * lunit / 2;
+        }
+        else if (section == "structure")
+        {
+            if (tag.name == "volume")
+            {
+                if (++nr_of_volumes > 1 || tag.get("name") == nullptr) return nullptr;
+                world_name = *tag.get("name");
+            }
+            else if (tag.name == "solidref" && !in_physvol)
+            {
+                if (tag.get("ref") == nullptr) return nullptr;
+                world_solid = *tag.get("ref");
+            }
+            else if (tag.name == "physvol")
+            {
+                G4double copy_nr;
+                if (!toDouble(tag.get("copynumber"), copy_nr, 0)) return nullptr;
+
+                OMGDMLVolumeFile file;
+                file.copy_nr = copy_nr;
+                file.placement_name = tag.get("name") ? *tag.get("name") : "";
+                file.is_box  = false;
+                file.solid   = nullptr;
+                file.ok      = false;
+                files.push_back(file);
+                in_physvol = !tag.self_closing;
+            }
+            else if (in_physvol && tag.name == "file" && tag.get("name") != nullptr)
+            {
+                files.back().filename = *tag.get("name");
+            }
+            else if (in_physvol && (tag.name == "positionref" || tag.name == "rotationref"))
+            {
+                std::unordered_map<std::string, G4ThreeVector>& defines = tag.name == "positionref" ? positions : rotations;
+                if (tag.get("ref") == nullptr || defines.count(*tag.get("ref")) == 0) return nullptr;
+                (tag.name == "positionref" ? files.back().position : files.back().rotation) = defines[*tag.get("ref")];
+            }
+            else if (in_physvol && (tag.name == "position" || tag.name == "rotation"))
+            {
+                if (!toVector(tag, "unit", tag.name == "rotation", tag.name == "position" ? files.back().position : files.back().rotation)) return nullptr;
+            }
+            else if (tag.name != "materialref")
+            {
+                // volumeref, assemblies, replicas, ...
+                return nullptr;
+            }
+        }
+    }
+
+    if (error || files.empty() || world_name.empty() || world_solid != box_name) return nullptr;
+    for (const OMGDMLVolumeFile& file : files) if (file.filename.empty()) return nullptr;
+
+    //-----------
+    // parse part files and create facets on all threads
+    //-----------
+
+    G4int nr_of_threads = std::min<G4int>(this->_nr_of_threads, files.size());
+
+    // singleton used by all facets, create before the threads start
+    G4GeometryTolerance::GetInstance();
+
+    runParallel(nr_of_threads, files.size(), [this, &files](size_t i)
+    {
+        files[i].ok = this->readVolumeFile(files[i]);
+    });
+
+    G4bool all_ok = true;
+    for (const OMGDMLVolumeFile& file : files) all_ok = all_ok && file.ok;
+    if (!all_ok)
+    {
+        for (OMGDMLVolumeFile& file : files) for (G4VFacet* facet : file.facets) delete facet;
+        return nullptr;
+    }
+
+    //-----------
+    // solids are registered in the solid store on this thread, closed (voxelized) on all threads
+    //-----------
+
+    std::vector<size_t> order;
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        if (files[i].is_box) continue;
+        files[i].solid = new G4TessellatedSolid(files[i].solid_name);
+        order.push_back(i);
+    }
+
+    // largest meshes first for an even load
+    std::sort(order.begin(), order.end(), [&files](size_t a, size_t b){return files[a].facets.size() > files[b].facets.size();});
+
+    runParallel(nr_of_threads, order.size(), [&files, &order](size_t i)
+    {
+        OMGDMLVolumeFile& file = files[order[i]];
+        for (G4VFacet* facet : file.facets) file.solid->AddFacet(facet);
+        file.solid->SetSolidClosed(true);
+    });
+
+    //-----------
+    // world and placements
+    //-----------
+
+    G4Box*           world_box     = new G4Box(box_name, box_half_size.x(), box_half_size.y(), box_half_size.z());
+    G4LogicalVolume* world_logical = new G4LogicalVolume(world_box, nullptr, world_name);
+
+    for (const OMGDMLVolumeFile& file : files)
+    {
+        G4VSolid* solid = file.solid;
+        if (file.is_box) solid = new G4Box(file.solid_name, file.box_half_size.x(), file.box_half_size.y(), file.box_half_size.z());
+
+        // materials are assigned by name afterwards
+        G4LogicalVolume* logical = new G4LogicalVolume(solid, nullptr, file.volume_name);
+
+        // same convention as G4GDMLReadStructure
+        G4RotationMatrix rotation;
+        rotation.rotateX(file.rotation.x());
+        rotation.rotateY(file.rotation.y());
+        rotation.rotateZ(file.rotation.z());
+        rotation.rectify();
+
+        G4String placement_name = file.placement_name.empty() ? file.volume_name + "_PV" : file.placement_name;
+        new G4PVPlacement(G4Transform3D(rotation.inverse(), file.position), logical, placement_name, world_logical, false, file.copy_nr);
+    }
+
+    G4cout << ">> " << files.size() << " volumes read from " << filename << " on " << nr_of_threads << " threads" << G4endl;
+
+    return new G4PVPlacement(nullptr, G4ThreeVector(), world_logical, world_name + "_PV", nullptr, false, 0);
+}
+
+G4bool OMGDMLLoader::readVolumeFile(OMGDMLVolumeFile& file)
+{
+    std::ifstream in(file.filename, std::ios::binary);
+    if (!in.is_open()) return false;
+    std::stringstream content;
+    content << in.rdbuf();
+    const std::string text = content.str();
+
+    struct Solid
+    {
+        G4bool                  is_box;
+        G4ThreeVector           box_half_size;
+        std::vector<G4VFacet*>  facets;
+    };
+
+    std::unordered_map<std::string, G4ThreeVector> positions;
+    std::map<std::string, Solid>                   solids;
+    G4String                                       tessellated  = "";
+    G4String                                       section      = "";
+    G4String                                       volume_solid = "";
+    G4String                                       world_ref    = "";
+    G4int                                          nr_of_volumes = 0;
+    G4bool                                         ok = true;
+
+    OMXMLTag tag;
+    G4bool   error = false;
+    size_t   pos   = 0;
+    while (ok && nextTag(text, pos, tag, error))
+    {
+        if (tag.closing)
+        {
+            if (tag.name == section)       section = "";
+            if (tag.name == "tessellated") tessellated = "";
+            continue;
+        }
+
+        if (tag.name == "define" || tag.name == "materials" || tag.name == "solids" || tag.name == "structure" || tag.name == "setup")
+        {
+            if (!tag.self_closing) section = tag.name;
+        }
+        else if (section == "define")
+        {
+            if (tag.name != "position") continue;
+            G4ThreeVector value;
+            ok = tag.get("name") != nullptr && toVector(tag, "unit", false, value);
+            if (ok) positions[*tag.get("name")] = value;
+        }
+        else if (section == "solids")
+        {
+            if (tag.name == "tessellated")
+            {
+                ok = tag.get("name") != nullptr;
+                if (!ok) break;
+                solids[*tag.get("name")].is_box = false;
+                if (!tag.self_closing) tessellated = *tag.get("name");
+            }
+            else if ((tag.name == "triangular" || tag.name == "quadrangular") && !tessellated.empty())
+            {
+                // relative facets are rare in exported meshes, G4GDMLParser handles them
+                const std::string* type = tag.get("type");
+                G4double lunit;
+                ok = (type == nullptr || *type == "ABSOLUTE") && toUnit(tag.get("lunit"), lunit, false);
+
+                G4int nr_of_vertices = tag.name == "triangular" ? 3 : 4;
+                G4ThreeVector vertices[4];
+                for (G4int i = 0; ok && i < nr_of_vertices; i++)
+                {
+                    const std::string key = "vertex" + std::to_string(i + 1);
+                    auto found = tag.get(key.c_str()) ? positions.find(*tag.get(key.c_str())) : positions.end();
+                    ok = found != positions.end();
+                    if (ok) vertices[i] = found->second * (lunit / mm);
+                }
+                if (!ok) break;
+
+                if (nr_of_vertices == 3) solids[tessellated].facets.push_back(new G4TriangularFacet(vertices[0], vertices[1], vertices[2], ABSOLUTE));
+                else                     solids[tessellated].facets.push_back(new G4QuadrangularFacet(vertices[0], vertices[1], vertices[2], vertices[3], ABSOLUTE));
+            }
+            else if (tag.name == "box")
+            {
+                G4double lunit, x, y, z;
+                ok = tag.get("name") != nullptr && toUnit(tag.get("lunit"), lunit, false) &&
+                     toDouble(tag.get("x"), x, 0) && toDouble(tag.get("y"), y, 0) && toDouble(tag.get("z"), z, 0);
+                if (!ok) break;
+                Solid& box = solids[*tag.get("name")];
+                box.is_box        = true;
+                box.box_half_size = G4ThreeVector(x, y, z) * lunit / 2;
+            }
+            else ok = false;
+        }
+        else if (section == "structure")
+        {
+            if (tag.name == "volume")
+            {
+                ok = ++nr_of_volumes == 1 && tag.get("name") != nullptr;
+                if (ok) file.volume_name = *tag.get("name");
+            }
+            else if (tag.name == "solidref")
+            {
+                ok = tag.get("ref") != nullptr;
+                if (ok) volume_solid = *tag.get("ref");
+            }
+            else ok = tag.name == "materialref";
+        }
+        else if (section == "setup" && tag.name == "world")
+        {
+            ok = tag.get("ref") != nullptr;
+            if (ok) world_ref = *tag.get("ref");
+        }
+    }
+
+    ok = ok && !error && nr_of_volumes == 1 && solids.count(volume_solid) && (world_ref.empty() || world_ref == file.volume_name);
+
+    //-----------
+    // keep the facets of the placed solid only
+    //-----------
+
+    for (auto& solid : solids)
+    {
+        if (ok && solid.first == volume_solid)
+        {
+            file.solid_name    = solid.first;
+            file.is_box        = solid.second.is_box;
+            file.box_half_size = solid.second.box_half_size;
+            file.facets        = std::move(solid.second.facets);
+        }
+        else for (G4VFacet* facet : solid.second.facets) delete facet;
+    }
+
+    return ok;
+}
\ No newline at end of file
@@ -0,0 +1,562 @@
+// system includes
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <sys/stat.h>
+
+// G4 includes
+#include "G4VPhysicalVolume.hh"
+#include "G4PVPlacement.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Box.hh"
+#include "G4Orb.hh"
+#include "G4Sphere.hh"
+#include "G4Tubs.hh"
+#include "G4Cons.hh"
+#include "G4Ellipsoid.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4TriangularFacet.hh"
+#include "G4QuadrangularFacet.hh"
+
+// project includes
+#include "OMGeometryCache.hh"
+
+static const char          geometry_cache_magic[8] = "OMGEOC1";
+static const std::uint32_t geometry_cache_version  = 1;
+
+enum OMCachedSolidType : std::uint32_t
+{
+    cached_box          = 0,
+    cached_tessellated  = 1,
+    cached_orb          = 2,
+    cached_sphere       = 3,
+    cached_tubs         = 4,
+    cached_cons         = 5,
+    cached_ellipsoid    = 6
+};
+
+// number of parameters of the analytic solids, in constructor order
+static G4int nrOfParameters(std::uint32_t type)
+{
+    switch (type)
+    {
+        case cached_box:       return 3;
+        case cached_orb:       return 1;
+        case cached_sphere:    return 6;
+        case cached_tubs:      return 5;
+        case cached_cons:      return 7;
+        case cached_ellipsoid: return 5;
+        default:               return -1;
+    }
+}
+
+
+//-----------
+// binary helpers
+//-----------
+
+template <typename T>
+static void put(std::vector<char>& data, T value)
+{
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+static void putString(std::vector<char>& data, const G4String& value)
+{
+    put<std::uint32_t>(data, value.size());
+    data.insert(data.end(), value.begin(), value.end());
+}
+
+class OMCacheStream
+{
+    public:
+
+        OMCacheStream(const std::vector<char>& data): _data(data), _pos(0), _ok(true) {};
+
+        template <typename T>
+        T get()
+        {
+            T value{};
+            if (this->_pos + sizeof(T) > this->_data.size()) {this->_ok = false; return value;}
+            std::memcpy(&value, this->_data.data() + this->_pos, sizeof(T));
+            this->_pos += sizeof(T);
+            return value;
+        }
+
+        G4String getString()
+        {
+            std::uint32_t length = this->get<std::uint32_t>();
+            if (!this->_ok || this->_pos + length > this->_data.size()) {this->_ok = false; return "";}
+            G4String value(std::string(this->_data.data() + this->_pos, length));
+            this->_pos += length;
+            return value;
+        }
+
+        G4bool ok(){return this->_ok;};
+
+    private:
+
+        const std::vector<char>& _data;
+        size_t                   _pos;
+        G4bool                   _ok;
+};
+
+
+//-----------
+// intermediate representation, the cache is fully read before any volume is created
+//-----------
+
+struct OMCachedSolid
+{
+    G4String                    name;
+    std::uint32_t               type;
+    std::vector<G4double>       parameters;     // analytic solids
+    std::vector<G4double>       vertices;       // x, y, z
+    std::vector<std::uint8_t>   facet_sizes;    // 3 or 4
+    std::vector<std::uint32_t>  facet_vertices;
+};
+
+struct OMCachedLogical
+{
+    G4String name;
+    G4int    solid;
+    G4String material;
+};
+
+struct OMCachedPlacement
+{
+    G4int    mother;
+    G4int    logical;
+    G4String name;
+    G4double rotation[9];
+    G4double translation[3];
+    G4int    copy_nr;
+};
+
+
+OMGeometryCache::OMGeometryCache(G4String directory, G4String gdml_filename, G4String settings)
+: _filename(""),
+ _directory(directory),
+ _key(14695981039346656037ULL),
+ _nr_of_placements(0),
+ _save_ok(true)
+{
+    //-----------
+    // key from the gdml file, all files it references and the settings
+    //-----------
+
+    this->_key = OMGeometryCache::hashFile(gdml_filename, this->_key);
+
+    std::ifstream gdml(gdml_filename);
+    std::stringstream content;
+    content << gdml.rdbuf();
+    const std::string text = content.str();
+
+    const std::string file_tag = "<file name=\"";
+    for (size_t pos = text.find(file_tag); pos != std::string::npos; pos = text.find(file_tag, pos))
+    {
+        pos += file_tag.size();
+        size_t end = text.find('"', pos);
+        if (end == std::string::npos) break;
+        this->_key = OMGeometryCache::hashFile(text.substr(pos, end - pos), this->_key);
+    }
+
+    for (char c : settings + geometry_cache_magic) this->_key = (this->_key ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+
+    //-----------
+    // cache file name
+    //-----------
+
+    std::stringstream filename;
+    filename << directory << "/geometry_" << std::hex << std::setw(16) << std::setfill('0') << this->_key << ".omgeo";
+    this->_filename = filename.str();
+}
+
+OMGeometryCache::~OMGeometryCache()
+{
+    // TODO
+}
+
+std::uint64_t OMGeometryCache::hashFile(const G4String& filename, std::uint64_t hash)
+{
+    // FNV-1a over file name and content
+    for (char c : filename) hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+
+    std::ifstream file(filename, std::ios::binary);
+    std::vector<char> buffer(1 << 20);
+    while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0)
+    {
+        const std::streamsize length = file.gcount();
+        for (std::streamsize i = 0; i < length; i++) hash = (hash ^ static_cast<unsigned char>(buffer[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+//-----------
+// save
+//-----------
+
+G4bool OMGeometryCache::save(G4VPhysicalVolume* world)
+{
+    this->_solid_index.clear();
+    this->_logical_index.clear();
+    this->_solid_data.clear();
+    this->_logical_data.clear();
+    this->_placement_data.clear();
+    this->_nr_of_placements = 0;
+    this->_save_ok = true;
+
+    this->writeLogical(world->GetLogicalVolume());
+    if (!this->_save_ok) return false;
+
+    std::vector<char> data;
+    data.insert(data.end(), geometry_cache_magic, geometry_cache_magic + sizeof(geometry_cache_magic));
+    put<std::uint32_t>(data, geometry_cache_version);
+    put<std::uint64_t>(data, this->_key);
+
+    put<std::uint32_t>(data, this->_solid_index.size());
+    data.insert(data.end(), this->_solid_data.begin(), this->_solid_data.end());
+    put<std::uint32_t>(data, this->_logical_index.size());
+    data.insert(data.end(), this->_logical_data.begin(), this->_logical_data.end());
+    put<std::uint32_t>(data, this->_nr_of_placements);
+    data.insert(data.end(), this->_placement_data.begin(), this->_placement_data.end());
+
+    put<std::int32_t>(data, this->_logical_index[world->GetLogicalVolume()]);
+    putString(data, world->GetName());
+
+    mkdir(this->_directory.c_str(), 0755);
+
+    // write to a temporary file first, so concurrent jobs never read a partial cache
+    G4String tmp_filename = this->_filename + ".tmp";
+    std::ofstream file(tmp_filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(data.data(), data.size());
+    file.close();
+    if (!file) return false;
+
+    return std::rename(tmp_filename.c_str(), this->_filename.c_str()) == 0;
+}
+
+void OMGeometryCache::writeLogical(G4LogicalVolume* logical)
+{
+    if (this->_logical_index.count(logical)) return;
+
+    // daughters first, so logical volumes and placements are only referenced after being written
+    for (size_t i = 0; i < logical->GetNoDaughters(); i++)
+    {
+        this->writeLogical(logical->GetDaughter(i)->GetLogicalVolume());
+    }
+
+    G4int solid = this->writeSolid(logical->GetSolid());
+    G4int index = this->_logical_index.size();
+    this->_logical_index[logical] = index;
+
+    putString(this->_logical_data, logical->GetName());
+    put<std::int32_t>(this->_logical_data, solid);
+    putString(this->_logical_data, logical->GetMaterial() ? logical->GetMaterial()->GetName() : G4String(""));
+
+    for (size_t i = 0; i < logical->GetNoDaughters(); i++)
+    {
+        G4VPhysicalVolume* daughter    = logical->GetDaughter(i);
+        G4RotationMatrix   rotation    = daughter->GetObjectRotationValue();
+        G4ThreeVector      translation = daughter->GetObjectTranslation();
+
+        put<std::int32_t>(this->_placement_data, index);
+        put<std::int32_t>(this->_placement_data, this->_logical_index[daughter->GetLogicalVolume()]);
+        putString(this->_placement_data, daughter->GetName());
+        put<G4double>(this->_placement_data, rotation.xx());
+        put<G4double>(this->_placement_data, rotation.xy());
+        put<G4double>(this->_placement_data, rotation.xz());
+        put<G4double>(this->_placement_data, rotation.yx());
+        put<G4double>(this->_placement_data, rotation.yy());
+        put<G4double>(this->_placement_data, rotation.yz());
+        put<G4double>(this->_placement_data, rotation.zx());
+        put<G4double>(this->_placement_data, rotation.zy());
+        put<G4double>(this->_placement_data, rotation.zz());
+        put<G4double>(this->_placement_data, translation.x());
+        put<G4double>(this->_placement_data, translation.y());
+        put<G4double>(this->_placement_data, translation.z());
+        put<std::int32_t>(this->_placement_data, daughter->GetCopyNo());
+        this->_nr_of_placements++;
+    }
+}
+
+G4int OMGeometryCache::writeSolid(G4VSolid* solid)
+{
+    if (this->_solid_index.count(solid)) return this->_solid_index[solid];
+
+    G4int index = this->_solid_index.size();
+    this->_solid_index[solid] = index;
+
+    putString(this->_solid_data, solid->GetName());
+
+    if (solid->GetEntityType() == "G4Box")
+    {
+        G4Box* box = static_cast<G4Box*>(solid);
+        put<std::uint32_t>(this->_solid_data, cached_box);
+        put<G4double>(this->_solid_data, box->GetXHalfLength());
+        put<G4double>(this->_solid_data, box->GetYHalfLength());
+        put<G4double>(this->_solid_data, box->GetZHalfLength());
+    }
+    else if (solid->GetEntityType() == "G4Orb")
+    {
+        G4Orb* orb = static_cast<G4Orb*>(solid);
+        put<std::uint32_t>(this->_solid_data, cached_orb);
+        put<G4double>(this->_solid_data, orb->GetRadius());
+    }
+    else if (solid->GetEntityType() == "G4Sphere")
+    {
+        G4Sphere* sphere = static_cast<G4Sphere*>(solid);
+        put<std::uint32_t>(this->_solid_data, cached_sphere);
+        put<G4double>(this->_solid_data, sphere->GetInnerRadius());
+        put<G4double>(this->_solid_data, sphere->GetOuterRadius());
+        put<G4double>(this->_solid_data, sphere->GetStartPhiAngle());
+        put<G4double>(this->_solid_data, sphere->GetDeltaPhiAngle());
+        put<G4double>(this->_solid_data, sphere->GetStartThetaAngle());
+        put<G4double>(this->_solid_data, sphere->GetDeltaThetaAngle());
+    }
+    else if (solid->GetEntityType() == "G4Tubs")
+    {
+        G4Tubs* tubs = static_cast<G4Tubs*>(solid);
+        put<std::uint32_t>(this->_solid_data, cached_tubs);
+        put<G4double>(this->_solid_data, tubs->GetInnerRadius());
+        put<G4double>(this->_solid_data, tubs->GetOuterRadius());
+        put<G4double>(this->_solid_data, tubs->GetZHalfLength());
+        put<G4double>(this->_solid_data, tubs->GetStartPhiAngle());
+        put<G4double>(this->_solid_data, tubs->GetDeltaPhiAngle());
+    }
+    else if (solid->GetEntityType() == "G4Cons")
+    {
+        G4Cons* cons = static_cast<G4Cons*>(solid);
+        put<std::uint32_t>(this->_solid_data, cached_cons);
+        put<G4double>(this->_solid_data, cons->GetInnerRadiusMinusZ());
+        put<G4double>(this->_solid_data, cons->GetOuterRadiusMinusZ());
+        put<G4double>(this->_solid_data, cons->GetInnerRadiusPlusZ());
+        put<G4double>(this->_solid_data, cons->GetOuterRadiusPlusZ());
+        put<G4double>(this->_solid_data, cons->GetZHalfLength());
+        put<G4double>(this->_solid_data, cons->GetStartPhiAngle());
+        put<G4double>(this->_solid_data, cons->GetDeltaPhiAngle());
+    }
+    else if (solid->GetEntityType() == "G4Ellipsoid")
+    {
+        G4Ellipsoid* ellipsoid = static_cast<G4Ellipsoid*>(solid);
+        put<std::uint32_t>(this->_solid_data, cached_ellipsoid);
+        for (G4int i = 0; i < 3; i++) put<G4double>(this->_solid_data, ellipsoid->GetSemiAxisMax(i));
+        put<G4double>(this->_solid_data, ellipsoid->GetZBottomCut());
+        put<G4double>(this->_solid_data, ellipsoid->GetZTopCut());
+    }
+    else if (solid->GetEntityType() == "G4TessellatedSolid")
+    {
+        G4TessellatedSolid* tessellated = static_cast<G4TessellatedSolid*>(solid);
+        put<std::uint32_t>(this->_solid_data, cached_tessellated);
+
+        // shared vertex table, facets reference it by index
+        std::map<std::array<G4double, 3>, std::uint32_t> vertex_index;
+        std::vector<char> vertex_data;
+        std::vector<char> facet_data;
+
+        for (G4int i = 0; i < tessellated->GetNumberOfFacets(); i++)
+        {
+            G4VFacet* facet = tessellated->GetFacet(i);
+            put<std::uint8_t>(facet_data, facet->GetNumberOfVertices());
+            for (G4int j = 0; j < facet->GetNumberOfVertices(); j++)
+            {
+                G4ThreeVector vertex = facet->GetVertex(j);
+                std::array<G4double, 3> key = {vertex.x(), vertex.y(), vertex.z()};
+                auto found = vertex_index.find(key);
+                if (found == vertex_index.end())
+                {
+                    found = vertex_index.emplace(key, vertex_index.size()).first;
+                    for (G4double coord : key) put<G4double>(vertex_data, coord);
+                }
+                put<std::uint32_t>(facet_data, found->second);
+            }
+        }
+
+        put<std::uint32_t>(this->_solid_data, vertex_index.size());
+        this->_solid_data.insert(this->_solid_data.end(), vertex_data.begin(), vertex_data.end());
+        put<std::uint32_t>(this->_solid_data, tessellated->GetNumberOfFacets());
+        this->_solid_data.insert(this->_solid_data.end(), facet_data.begin(), facet_data.end());
+    }
+    else
+    {
+        G4Exception("OMGeometryCache::writeSolid()",
+                    "solid can not be cached",
+                    JustWarning,
+                    ("the solid " + solid->GetName() + " of type " + solid->GetEntityType() + " is not supported by the geometry cache. No cache is written!").c_str());
+        this->_save_ok = false;
+    }
+
+    return index;
+}
+
+//-----------
+// load
+//-----------
+
+static G4VPhysicalVolume* corruptCache(const G4String& filename)
+{
+    G4Exception("OMGeometryCache::load()",
+                "corrupt geometry cache",
+                JustWarning,
+                ("the geometry cache " + filename + " is corrupt and will be ignored.").c_str());
+    return nullptr;
+}
+
+G4VPhysicalVolume* OMGeometryCache::load()
+{
+    std::ifstream file(this->_filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return nullptr;
+
+    std::vector<char> data(file.tellg());
+    file.seekg(0);
+    file.read(data.data(), data.size());
+    if (!file) return nullptr;
+
+    OMCacheStream stream(data);
+
+    //-----------
+    // header
+    //-----------
+
+    char magic[8];
+    for (char& c : magic) c = stream.get<char>();
+    std::uint32_t version = stream.get<std::uint32_t>();
+    std::uint64_t key     = stream.get<std::uint64_t>();
+
+    if (!stream.ok() || std::memcmp(magic, geometry_cache_magic, sizeof(magic)) != 0 || version != geometry_cache_version || key != this->_key)
+    {
+        return nullptr;
+    }
+
+    //-----------
+    // read everything before creating volumes
+    //-----------
+
+    std::vector<OMCachedSolid> solids(stream.get<std::uint32_t>());
+    if (solids.size() > data.size()) return corruptCache(this->_filename);
+    for (OMCachedSolid& solid : solids)
+    {
+        if (!stream.ok()) return corruptCache(this->_filename);
+        solid.name = stream.getString();
+        solid.type = stream.get<std::uint32_t>();
+
+        if (nrOfParameters(solid.type) > 0)
+        {
+            for (G4int i = 0; i < nrOfParameters(solid.type); i++) solid.parameters.push_back(stream.get<G4double>());
+        }
+        else if (solid.type == cached_tessellated)
+        {
+            std::uint32_t nr_of_vertices = stream.get<std::uint32_t>();
+            if (!stream.ok() || nr_of_vertices > data.size()) return corruptCache(this->_filename);
+            solid.vertices.resize(3 * nr_of_vertices);
+            for (G4double& coord : solid.vertices) coord = stream.get<G4double>();
+
+            std::uint32_t nr_of_facets = stream.get<std::uint32_t>();
+            if (!stream.ok() || nr_of_facets > data.size()) return corruptCache(this->_filename);
+            solid.facet_sizes.resize(nr_of_facets);
+            for (std::uint8_t& size : solid.facet_sizes)
+            {
+                size = stream.get<std::uint8_t>();
+                if (size != 3 && size != 4) return corruptCache(this->_filename);
+                for (G4int j = 0; j < size; j++)
+                {
+                    std::uint32_t vertex = stream.get<std::uint32_t>();
+                    if (vertex >= nr_of_vertices) return corruptCache(this->_filename);
+                    solid.facet_vertices.push_back(vertex);
+                }
+            }
+        }
+        else return corruptCache(this->_filename);
+    }
+
+    std::vector<OMCachedLogical> logicals(stream.get<std::uint32_t>());
+    if (!stream.ok() || logicals.size() > data.size()) return corruptCache(this->_filename);
+    for (OMCachedLogical& logical : logicals)
+    {
+        logical.name     = stream.getString();
+        logical.solid    = stream.get<std::int32_t>();
+        logical.material = stream.getString();
+        if (!stream.ok() || logical.solid < 0 || logical.solid >= (G4int) solids.size()) return corruptCache(this->_filename);
+    }
+
+    std::vector<OMCachedPlacement> placements(stream.get<std::uint32_t>());
+    if (!stream.ok() || placements.size() > data.size()) return corruptCache(this->_filename);
+    for (OMCachedPlacement& placement : placements)
+    {
+        placement.mother  = stream.get<std::int32_t>();
+        placement.logical = stream.get<std::int32_t>();
+        placement.name    = stream.getString();
+        for (G4double& value : placement.rotation)    value = stream.get<G4double>();
+        for (G4double& value : placement.translation) value = stream.get<G4double>();
+        placement.copy_nr = stream.get<std::int32_t>();
+        if (!stream.ok() || placement.mother  < 0 || placement.mother  >= (G4int) logicals.size()
+                         || placement.logical < 0 || placement.logical >= (G4int) logicals.size()) return corruptCache(this->_filename);
+    }
+
+    G4int    world_logical = stream.get<std::int32_t>();
+    G4String world_name    = stream.getString();
+
+    if (!stream.ok() || world_logical < 0 || world_logical >= (G4int) logicals.size()) return corruptCache(this->_filename);
+
+    //-----------
+    // create solids, logical volumes and placements
+    //-----------
+
+    std::vector<G4VSolid*> solid_ptrs;
+    for (const OMCachedSolid& solid : solids)
+    {
+        const std::vector<G4double>& p = solid.parameters;
+        switch (solid.type)
+        {
+            case cached_box:       solid_ptrs.push_back(new G4Box(solid.name, p[0], p[1], p[2]));                     continue;
+            case cached_orb:       solid_ptrs.push_back(new G4Orb(solid.name, p[0]));                                  continue;
+            case cached_sphere:    solid_ptrs.push_back(new G4Sphere(solid.name, p[0], p[1], p[2], p[3], p[4], p[5])); continue;
+            case cached_tubs:      solid_ptrs.push_back(new G4Tubs(solid.name, p[0], p[1], p[2], p[3], p[4]));        continue;
+            case cached_cons:      solid_ptrs.push_back(new G4Cons(solid.name, p[0], p[1], p[2], p[3], p[4], p[5], p[6])); continue;
+            case cached_ellipsoid: solid_ptrs.push_back(new G4Ellipsoid(solid.name, p[0], p[1], p[2], p[3], p[4]));   continue;
+            default:               break;
+        }
+
+        G4TessellatedSolid* tessellated = new G4TessellatedSolid(solid.name);
+        const std::uint32_t* index = solid.facet_vertices.data();
+        auto vertex = [&solid](std::uint32_t i){return G4ThreeVector(solid.vertices[3*i], solid.vertices[3*i+1], solid.vertices[3*i+2]);};
+
+        for (std::uint8_t size : solid.facet_sizes)
+        {
+            if (size == 3) tessellated->AddFacet(new G4TriangularFacet(vertex(index[0]), vertex(index[1]), vertex(index[2]), ABSOLUTE));
+            else           tessellated->AddFacet(new G4QuadrangularFacet(vertex(index[0]), vertex(index[1]), vertex(index[2]), vertex(index[3]), ABSOLUTE));
+            index += size;
+        }
+        tessellated->SetSolidClosed(true);
+        solid_ptrs.push_back(tessellated);
+    }
+
+    std::vector<G4LogicalVolume*> logical_ptrs;
+    for (const OMCachedLogical& logical : logicals)
+    {
+        // materials are reassigned by the detector construction, missing ones are set there
+        logical_ptrs.push_back(new G4LogicalVolume(solid_ptrs[logical.solid], G4Material::GetMaterial(logical.material, false), logical.name));
+    }
+
+    for (const OMCachedPlacement& placement : placements)
+    {
+        // rotation is stored row by row, constructed from its columns
+        const G4double* r = placement.rotation;
+        G4RotationMatrix rotation(G4ThreeVector(r[0], r[3], r[6]), G4ThreeVector(r[1], r[4], r[7]), G4ThreeVector(r[2], r[5], r[8]));
+
+        new G4PVPlacement(G4Transform3D(rotation, G4ThreeVector(placement.translation[0], placement.translation[1], placement.translation[2])),
+                          logical_ptrs[placement.logical],
+                          placement.name,
+                          logical_ptrs[placement.mother],
+                          false,
+                          placement.copy_nr);
+    }
+
+    return new G4PVPlacement(nullptr, G4ThreeVector(), logical_ptrs[world_logical], world_name, nullptr, false, 0);
+}
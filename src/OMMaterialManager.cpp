@@ -38,7 +38,8 @@ _glassSurface(nullptr),
 _gelSurface(nullptr),
 _titaniumSurface(nullptr),
 _plasticSurface(nullptr),
-_reflectorSurface(nullptr)
+_reflectorSurface(nullptr),
+_quantumEfficiency(nullptr)
 {
     this->_datareader = new OMDataReader("macros/optical_properties.cfg");
 }
@@ -46,6 +47,7 @@ _reflectorSurface(nullptr)
 OMMaterialManager::~OMMaterialManager()
 {
     delete this->_datareader;
+    delete this->_quantumEfficiency;
 }
 
 G4Material* OMMaterialManager::BuildVacuum()
@@ -371,4 +373,22 @@ G4OpticalSurface* OMMaterialManager::BuildPhotocathodeSurface()
 
     this->_photocathodeSurface = photocathodeSurface;
     return photocathodeSurface;
+}
+
+///-----------------------------------------------------------------------
+
+G4double OMMaterialManager::GetQuantumEfficiency(G4double energy)
+{
+    if (this->_quantumEfficiency == nullptr)
+    {
+        unsigned  length = this->_datareader->GetArrayLength("photoQEEnergy");
+        G4double* qe_energy = this->_datareader->GetArray("photoQEEnergy",length,eV);
+        G4double* qe        = this->_datareader->GetArray("photoQE",length);
+
+        this->_quantumEfficiency = new G4PhysicsFreeVector(qe_energy, qe, length);
+
+        delete[] qe_energy;
+        delete[] qe;
+    }
+    return this->_quantumEfficiency->Value(energy);
 }
\ No newline at end of file
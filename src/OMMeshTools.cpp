@@ -0,0 +1,973 @@
+// system includes
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <queue>
+#include <set>
+#include <unordered_map>
+
+// G4 includes
+#include "G4TessellatedSolid.hh"
+#include "G4VFacet.hh"
+#include "G4TriangularFacet.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4RotationMatrix.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Orb.hh"
+#include "G4Sphere.hh"
+#include "G4Tubs.hh"
+#include "G4Cons.hh"
+#include "G4Ellipsoid.hh"
+
+// project includes
+#include "OMMeshTools.hh"
+
+
+OMMesh OMMeshTools::getMesh(const G4TessellatedSolid* solid)
+{
+    OMMesh mesh;
+    std::map<std::array<G4double, 3>, G4int> vertex_index;
+
+    for (G4int i = 0; i < solid->GetNumberOfFacets(); i++)
+    {
+        G4VFacet* facet = solid->GetFacet(i);
+        std::array<G4int, 4> indices = {-1, -1, -1, -1};
+
+        for (G4int j = 0; j < facet->GetNumberOfVertices() && j < 4; j++)
+        {
+            G4ThreeVector vertex = facet->GetVertex(j);
+            auto found = vertex_index.emplace(std::array<G4double, 3>{vertex.x(), vertex.y(), vertex.z()}, (G4int) mesh.vertices.size());
+            if (found.second) mesh.vertices.push_back(vertex);
+            indices[j] = found.first->second;
+        }
+        mesh.facets.push_back(indices);
+    }
+
+    OMMeshTools::principalAxes(mesh);
+    return mesh;
+}
+
+void OMMeshTools::principalAxes(OMMesh& mesh)
+{
+    //-----------
+    // centroid and covariance of the vertices
+    //-----------
+
+    G4ThreeVector centroid, lower(DBL_MAX, DBL_MAX, DBL_MAX), upper(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+    for (const G4ThreeVector& vertex : mesh.vertices)
+    {
+        centroid += vertex;
+        for (G4int k = 0; k < 3; k++)
+        {
+            lower[k] = std::min(lower[k], vertex[k]);
+            upper[k] = std::max(upper[k], vertex[k]);
+        }
+    }
+    if (!mesh.vertices.empty()) centroid /= mesh.vertices.size();
+    mesh.centroid = centroid;
+    mesh.extent   = mesh.vertices.empty() ? 0 : std::max({upper.x() - lower.x(), upper.y() - lower.y(), upper.z() - lower.z()});
+
+    G4double a[3][3] = {{0}};
+    for (const G4ThreeVector& vertex : mesh.vertices)
+    {
+        G4ThreeVector d = vertex - centroid;
+        for (G4int i = 0; i < 3; i++) for (G4int j = 0; j < 3; j++) a[i][j] += d[i] * d[j];
+    }
+    if (!mesh.vertices.empty()) for (G4int i = 0; i < 3; i++) for (G4int j = 0; j < 3; j++) a[i][j] /= mesh.vertices.size();
+
+    //-----------
+    // jacobi eigenvalue iteration of the symmetric 3x3 matrix
+    //-----------
+
+    G4double v[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    for (G4int sweep = 0; sweep < 50; sweep++)
+    {
+        G4double off = std::fabs(a[0][1]) + std::fabs(a[0][2]) + std::fabs(a[1][2]);
+        if (off <= 1e-15 * (std::fabs(a[0][0]) + std::fabs(a[1][1]) + std::fabs(a[2][2]))) break;
+
+        for (G4int p = 0; p < 2; p++) for (G4int q = p + 1; q < 3; q++)
+        {
+            if (a[p][q] == 0) continue;
+            G4double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+            G4double t     = (theta >= 0 ? 1 : -1) / (std::fabs(theta) + std::sqrt(theta * theta + 1));
+            G4double c     = 1 / std::sqrt(t * t + 1);
+            G4double s     = t * c;
+
+            for (G4int k = 0; k < 3; k++)
+            {
+                G4double akp = a[k][p], akq = a[k][q];
+                a[k][p] = c * akp - s * akq;
+                a[k][q] = s * akp + c * akq;
+            }
+            for (G4int k = 0; k < 3; k++)
+            {
+                G4double apk = a[p][k], aqk = a[q][k];
+                a[p][k] = c * apk - s * aqk;
+                a[q][k] = s * apk + c * aqk;
+            }
+            for (G4int k = 0; k < 3; k++)
+            {
+                G4double vkp = v[k][p], vkq = v[k][q];
+                v[k][p] = c * vkp - s * vkq;
+                v[k][q] = s * vkp + c * vkq;
+            }
+        }
+    }
+
+    // sort descending
+    G4int order[3] = {0, 1, 2};
+    std::sort(order, order + 3, [&a](G4int i, G4int j){return a[i][i] > a[j][j];});
+    for (G4int i = 0; i < 3; i++)
+    {
+        mesh.eigenvalues[i] = a[order[i]][order[i]];
+        mesh.axes[i]        = G4ThreeVector(v[0][order[i]], v[1][order[i]], v[2][order[i]]).unit();
+    }
+
+    // right-handed frame, otherwise two copies of a mesh can get axes of opposite handedness and no proper rotation maps them
+    mesh.axes[2] = mesh.axes[0].cross(mesh.axes[1]);
+}
+
+G4bool OMMeshTools::findRigidTransform(const OMMesh& mesh_a, const OMMesh& mesh_b, G4Transform3D& transform, G4double tolerance)
+{
+    if (mesh_a.vertices.size() != mesh_b.vertices.size() || mesh_a.facets.size() != mesh_b.facets.size()) return false;
+    if (mesh_a.vertices.empty()) return false;
+
+    const G4double scale = std::max(mesh_a.extent, mesh_b.extent);
+    const G4double tol   = tolerance * scale;
+
+    //-----------
+    // same shape has the same principal moments. principal axes are only unique if the moments differ
+    //-----------
+
+    const G4double moment_tol = 1e-6 * mesh_a.eigenvalues[0] + tol * tol;
+    for (G4int i = 0; i < 3; i++) if (std::fabs(mesh_a.eigenvalues[i] - mesh_b.eigenvalues[i]) > moment_tol * 10) return false;
+    if (mesh_a.eigenvalues[0] - mesh_a.eigenvalues[1] < 1e-4 * mesh_a.eigenvalues[0]) return false;
+    if (mesh_a.eigenvalues[1] - mesh_a.eigenvalues[2] < 1e-4 * mesh_a.eigenvalues[0]) return false;
+
+    //-----------
+    // spatial hash of mesh b
+    //-----------
+
+    auto cell = [tol](const G4ThreeVector& p)
+    {
+        return std::array<long long, 3>{(long long) std::floor(p.x() / (4 * tol)), (long long) std::floor(p.y() / (4 * tol)), (long long) std::floor(p.z() / (4 * tol))};
+    };
+    std::map<std::array<long long, 3>, std::vector<G4int>> grid;
+    for (size_t i = 0; i < mesh_b.vertices.size(); i++) grid[cell(mesh_b.vertices[i])].push_back(i);
+
+    std::set<std::array<G4int, 4>> facets_b;
+    for (std::array<G4int, 4> facet : mesh_b.facets)
+    {
+        std::sort(facet.begin(), facet.end());
+        facets_b.insert(facet);
+    }
+
+    //-----------
+    // try the four proper rotations mapping the principal axes onto each other
+    //-----------
+
+    const G4double signs[4][3] = {{1, 1, 1}, {1, -1, -1}, {-1, 1, -1}, {-1, -1, 1}};
+    for (const auto& sign : signs)
+    {
+        // R = sum_k s_k * axis_b_k * axis_a_k^T
+        G4double r[3][3] = {{0}};
+        for (G4int k = 0; k < 3; k++) for (G4int i = 0; i < 3; i++) for (G4int j = 0; j < 3; j++)
+        {
+            r[i][j] += sign[k] * mesh_b.axes[k][i] * mesh_a.axes[k][j];
+        }
+        G4ThreeVector col_x(r[0][0], r[1][0], r[2][0]), col_y(r[0][1], r[1][1], r[2][1]), col_z(r[0][2], r[1][2], r[2][2]);
+        if (col_x.cross(col_y).dot(col_z) < 0) continue;
+
+        G4RotationMatrix rotation(col_x, col_y, col_z);
+        G4ThreeVector    translation = mesh_b.centroid - rotation * mesh_a.centroid;
+
+        // vertex correspondence
+        std::vector<G4int> mapping(mesh_a.vertices.size(), -1);
+        std::vector<G4bool> used(mesh_b.vertices.size(), false);
+        G4bool match = true;
+        for (size_t i = 0; match && i < mesh_a.vertices.size(); i++)
+        {
+            G4ThreeVector p = rotation * mesh_a.vertices[i] + translation;
+            std::array<long long, 3> c = cell(p);
+            for (long long dx = -1; dx <= 1 && mapping[i] < 0; dx++)
+            for (long long dy = -1; dy <= 1 && mapping[i] < 0; dy++)
+            for (long long dz = -1; dz <= 1 && mapping[i] < 0; dz++)
+            {
+                auto found = grid.find({c[0] + dx, c[1] + dy, c[2] + dz});
+                if (found == grid.end()) continue;
+                for (G4int j : found->second)
+                {
+                    if (!used[j] && (mesh_b.vertices[j] - p).mag2() <= tol * tol)
+                    {
+                        mapping[i] = j;
+                        used[j]    = true;
+                        break;
+                    }
+                }
+            }
+            match = mapping[i] >= 0;
+        }
+        if (!match) continue;
+
+        // facet connectivity
+        for (const std::array<G4int, 4>& facet : mesh_a.facets)
+        {
+            std::array<G4int, 4> mapped = {-1, -1, -1, -1};
+            for (G4int k = 0; k < 4; k++) if (facet[k] >= 0) mapped[k] = mapping[facet[k]];
+            std::sort(mapped.begin(), mapped.end());
+            if (!facets_b.count(mapped)) {match = false; break;}
+        }
+        if (!match) continue;
+
+        transform = G4Transform3D(rotation, translation);
+        return true;
+    }
+
+    return false;
+}
+
+G4TessellatedSolid* OMMeshTools::decimate(const G4TessellatedSolid* solid, G4double max_deviation)
+{
+    OMMesh mesh = OMMeshTools::getMesh(solid);
+
+    //-----------
+    // triangles (quadrangles are split) and their planes
+    //-----------
+
+    std::vector<std::array<G4int, 3>> triangles;
+    for (const std::array<G4int, 4>& facet : mesh.facets)
+    {
+        triangles.push_back({facet[0], facet[1], facet[2]});
+        if (facet[3] >= 0) triangles.push_back({facet[0], facet[2], facet[3]});
+    }
+
+    const size_t nr_of_vertices = mesh.vertices.size();
+    std::vector<G4ThreeVector>& position = mesh.vertices;
+
+    // coplanar triangles share one plane, keeps the plane lists short on flat parts
+    std::vector<G4ThreeVector>                   plane_normal;
+    std::vector<G4double>                        plane_offset;
+    std::vector<G4int>                           triangle_plane(triangles.size());
+    std::map<std::array<long long, 4>, G4int>    plane_index;
+    for (size_t t = 0; t < triangles.size(); t++)
+    {
+        const std::array<G4int, 3>& tri = triangles[t];
+        G4ThreeVector normal = (position[tri[1]] - position[tri[0]]).cross(position[tri[2]] - position[tri[0]]).unit();
+        G4double      offset = - normal.dot(position[tri[0]]);
+
+        std::array<long long, 4> key = {std::llround(normal.x() * 1e9), std::llround(normal.y() * 1e9), std::llround(normal.z() * 1e9), std::llround(offset / max_deviation * 1e3)};
+        auto found = plane_index.emplace(key, (G4int) plane_normal.size());
+        if (found.second)
+        {
+            plane_normal.push_back(normal);
+            plane_offset.push_back(offset);
+        }
+        triangle_plane[t] = found.first->second;
+    }
+
+    //-----------
+    // every edge has to be shared by exactly two triangles, in opposite directions
+    //-----------
+
+    std::map<std::pair<G4int, G4int>, G4int> edges;
+    for (const std::array<G4int, 3>& tri : triangles)
+    {
+        for (G4int k = 0; k < 3; k++) edges[{tri[k], tri[(k + 1) % 3]}]++;
+    }
+    for (const auto& edge : edges)
+    {
+        if (edge.second != 1 || edges.count({edge.first.second, edge.first.first}) == 0) return nullptr;
+    }
+
+    //-----------
+    // adjacency and the original planes each vertex represents
+    //-----------
+
+    std::vector<std::vector<G4int>> vertex_triangles(nr_of_vertices);
+    std::vector<std::vector<G4int>> vertex_planes(nr_of_vertices);
+    for (size_t t = 0; t < triangles.size(); t++)
+    {
+        for (G4int v : triangles[t])
+        {
+            vertex_triangles[v].push_back(t);
+            vertex_planes[v].push_back(triangle_plane[t]);
+        }
+    }
+
+    for (std::vector<G4int>& planes : vertex_planes)
+    {
+        std::sort(planes.begin(), planes.end());
+        planes.erase(std::unique(planes.begin(), planes.end()), planes.end());
+    }
+
+    const size_t        max_valence = 24;
+    std::vector<G4bool> triangle_alive(triangles.size(), true);
+    std::vector<G4int>  vertex_version(nr_of_vertices, 0);
+
+    auto neighbours = [&](G4int v)
+    {
+        std::set<G4int> result;
+        for (G4int t : vertex_triangles[v]) if (triangle_alive[t]) for (G4int w : triangles[t]) if (w != v) result.insert(w);
+        return result;
+    };
+
+    // cost of moving u onto v: largest distance of v to the original planes around u. negative if the collapse is not allowed
+    auto collapseCost = [&](G4int u, G4int v)
+    {
+        // link condition: u and v share exactly the two opposite vertices of their common triangles
+        std::set<G4int> ring_u = neighbours(u), ring_v = neighbours(v);
+        G4int common = 0;
+        for (G4int w : ring_u) if (ring_v.count(w)) common++;
+        if (common != 2) return -1.;
+
+        // hub vertices with hundreds of triangles make every later collapse around them expensive
+        if (ring_u.size() + ring_v.size() - 4 > max_valence) return -1.;
+
+        // the triangles moving with u must not flip or degenerate
+        for (G4int t : vertex_triangles[u])
+        {
+            if (!triangle_alive[t]) continue;
+            const std::array<G4int, 3>& tri = triangles[t];
+            if (tri[0] == v || tri[1] == v || tri[2] == v) continue;
+
+            G4ThreeVector p[3];
+            for (G4int k = 0; k < 3; k++) p[k] = position[tri[k] == u ? v : tri[k]];
+            G4ThreeVector old_normal = (position[tri[1]] - position[tri[0]]).cross(position[tri[2]] - position[tri[0]]);
+            G4ThreeVector new_normal = (p[1] - p[0]).cross(p[2] - p[0]);
+
+            G4double min_edge = std::min({(p[1] - p[0]).mag(), (p[2] - p[1]).mag(), (p[0] - p[2]).mag()});
+            if (new_normal.dot(old_normal) <= 0 || new_normal.mag() < 1e-3 * min_edge * min_edge || min_edge < 1e-6 * mm) return -1.;
+        }
+
+        G4double cost = 0;
+        for (G4int t : vertex_planes[u]) cost = std::max(cost, std::fabs(plane_normal[t].dot(position[v]) + plane_offset[t]));
+        return cost;
+    };
+
+    //-----------
+    // collapse edges, cheapest first
+    //-----------
+
+    struct Candidate
+    {
+        G4double cost;
+        G4int    u, v, version_u, version_v;
+        G4bool operator<(const Candidate& other) const {return this->cost > other.cost;};
+    };
+    std::priority_queue<Candidate> queue;
+
+    auto pushCandidates = [&](G4int u)
+    {
+        for (G4int v : neighbours(u))
+        {
+            for (const auto& pair : {std::make_pair(u, v), std::make_pair(v, u)})
+            {
+                G4double cost = collapseCost(pair.first, pair.second);
+                if (cost >= 0 && cost <= max_deviation) queue.push({cost, pair.first, pair.second, vertex_version[pair.first], vertex_version[pair.second]});
+            }
+        }
+    };
+
+    for (const auto& edge : edges)
+    {
+        if (edge.first.first > edge.first.second) continue;
+        for (const auto& pair : {edge.first, std::make_pair(edge.first.second, edge.first.first)})
+        {
+            G4double cost = collapseCost(pair.first, pair.second);
+            if (cost >= 0 && cost <= max_deviation) queue.push({cost, pair.first, pair.second, 0, 0});
+        }
+    }
+
+    size_t nr_of_triangles = triangles.size();
+    while (!queue.empty() && nr_of_triangles > 4)
+    {
+        Candidate candidate = queue.top();
+        queue.pop();
+
+        const G4int u = candidate.u, v = candidate.v;
+        if (candidate.version_u != vertex_version[u] || candidate.version_v != vertex_version[v]) continue;
+
+        // the neighbourhood may have changed without touching u or v
+        G4double cost = collapseCost(u, v);
+        if (cost < 0 || cost > max_deviation) continue;
+        if (cost > candidate.cost)
+        {
+            queue.push({cost, u, v, candidate.version_u, candidate.version_v});
+            continue;
+        }
+
+        // remove the two triangles sharing the edge, move the others to v
+        for (G4int t : vertex_triangles[u])
+        {
+            if (!triangle_alive[t]) continue;
+            std::array<G4int, 3>& tri = triangles[t];
+            if (tri[0] == v || tri[1] == v || tri[2] == v)
+            {
+                triangle_alive[t] = false;
+                nr_of_triangles--;
+                continue;
+            }
+            for (G4int& w : tri) if (w == u) w = v;
+            vertex_triangles[v].push_back(t);
+        }
+        vertex_triangles[u].clear();
+
+        std::vector<G4int>& around_v = vertex_triangles[v];
+        around_v.erase(std::remove_if(around_v.begin(), around_v.end(), [&triangle_alive](G4int t){return !triangle_alive[t];}), around_v.end());
+        for (G4int w : neighbours(v))
+        {
+            std::vector<G4int>& around_w = vertex_triangles[w];
+            around_w.erase(std::remove_if(around_w.begin(), around_w.end(), [&triangle_alive](G4int t){return !triangle_alive[t];}), around_w.end());
+        }
+
+        vertex_planes[v].insert(vertex_planes[v].end(), vertex_planes[u].begin(), vertex_planes[u].end());
+        std::sort(vertex_planes[v].begin(), vertex_planes[v].end());
+        vertex_planes[v].erase(std::unique(vertex_planes[v].begin(), vertex_planes[v].end()), vertex_planes[v].end());
+        vertex_planes[u].clear();
+
+        // edges of v changed their cost, all others are checked again when they are taken from the queue
+        vertex_version[u]++;
+        vertex_version[v]++;
+        pushCandidates(v);
+    }
+
+    if (nr_of_triangles == triangles.size()) return nullptr;
+
+    //-----------
+    // build the reduced solid
+    //-----------
+
+    G4TessellatedSolid* reduced = new G4TessellatedSolid(solid->GetName());
+    for (size_t t = 0; t < triangles.size(); t++)
+    {
+        if (!triangle_alive[t]) continue;
+        const std::array<G4int, 3>& tri = triangles[t];
+        reduced->AddFacet(new G4TriangularFacet(position[tri[0]], position[tri[1]], position[tri[2]], ABSOLUTE));
+    }
+    reduced->SetSolidClosed(true);
+
+    return reduced;
+}
+
+
+//-----------
+// primitive fitting, rotationally symmetric primitives are described by their profile in the (rho, z) half plane
+//-----------
+
+static G4double segmentDistance(G4double rho, G4double z, G4double rho_a, G4double z_a, G4double rho_b, G4double z_b)
+{
+    G4double d_rho   = rho_b - rho_a;
+    G4double d_z     = z_b - z_a;
+    G4double length2 = d_rho * d_rho + d_z * d_z;
+    G4double t       = length2 > 0 ? std::min(1., std::max(0., ((rho - rho_a) * d_rho + (z - z_a) * d_z) / length2)) : 0.;
+    return std::hypot(rho - rho_a - t * d_rho, z - z_a - t * d_z);
+}
+
+// arc around the origin between two polar angles
+static G4double arcDistance(G4double rho, G4double z, G4double radius, G4double theta_min, G4double theta_max)
+{
+    G4double theta = std::atan2(rho, z);
+    if (theta >= theta_min && theta <= theta_max) return std::fabs(std::hypot(rho, z) - radius);
+    return std::min(std::hypot(rho - radius * std::sin(theta_min), z - radius * std::cos(theta_min)),
+                    std::hypot(rho - radius * std::sin(theta_max), z - radius * std::cos(theta_max)));
+}
+
+// gaussian elimination with partial pivoting, the solution is returned in b
+static G4bool solveLinear(std::vector<std::vector<G4double>> a, std::vector<G4double>& b)
+{
+    const size_t n = b.size();
+    for (size_t col = 0; col < n; col++)
+    {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < n; row++) if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) pivot = row;
+        if (std::fabs(a[pivot][col]) < 1e-12) return false;
+        std::swap(a[col], a[pivot]);
+        std::swap(b[col], b[pivot]);
+
+        for (size_t row = col + 1; row < n; row++)
+        {
+            G4double factor = a[row][col] / a[col][col];
+            for (size_t k = col; k < n; k++) a[row][k] -= factor * a[col][k];
+            b[row] -= factor * b[col];
+        }
+    }
+    for (size_t col = n; col-- > 0;)
+    {
+        for (size_t k = col + 1; k < n; k++) b[col] -= a[col][k] * b[k];
+        b[col] /= a[col][col];
+    }
+    return true;
+}
+
+// frame with its z axis along the given axis
+static G4Transform3D frameAlong(const G4ThreeVector& axis, const G4ThreeVector& origin)
+{
+    G4ThreeVector u = axis.orthogonal().unit();
+    G4ThreeVector v = axis.cross(u);
+    return G4Transform3D(G4RotationMatrix(u, v, axis), origin);
+}
+
+G4double OMMeshTools::fitResidual(const OMMesh& mesh, const G4Transform3D& placement, G4double volume, G4double tolerance,
+                                  const std::function<G4double(const G4ThreeVector&)>& distance)
+{
+    const G4RotationMatrix to_local    = placement.getRotation().inverse();
+    const G4ThreeVector    translation = placement.getTranslation();
+
+    G4double residual = 0;
+    for (const G4ThreeVector& vertex : mesh.vertices)
+    {
+        residual = std::max(residual, distance(to_local * (vertex - translation)));
+        if (residual > tolerance) return -1;
+    }
+
+    // facet centres catch holes and flat parts between vertices on the primitive surface
+    G4double mesh_volume = 0;
+    G4double mesh_area   = 0;
+    for (const std::array<G4int, 4>& facet : mesh.facets)
+    {
+        const G4int   nr_of_corners = facet[3] >= 0 ? 4 : 3;
+        G4ThreeVector centre;
+        for (G4int k = 0; k < nr_of_corners; k++) centre += mesh.vertices[facet[k]];
+        centre /= nr_of_corners;
+
+        residual = std::max(residual, distance(to_local * (centre - translation)));
+        if (residual > tolerance) return -1;
+
+        for (G4int k = 1; k + 1 < nr_of_corners; k++)
+        {
+            const G4ThreeVector& a = mesh.vertices[facet[0]];
+            const G4ThreeVector& b = mesh.vertices[facet[k]];
+            const G4ThreeVector& c = mesh.vertices[facet[k + 1]];
+            mesh_volume += a.dot(b.cross(c)) / 6;
+            mesh_area   += (b - a).cross(c - a).mag() / 2;
+        }
+    }
+
+    // a surface shifted by the tolerance changes the volume by about area * tolerance
+    if (std::fabs(std::fabs(mesh_volume) - volume) > mesh_area * tolerance) return -1;
+
+    return residual;
+}
+
+G4VSolid* OMMeshTools::fitPrimitive(const G4TessellatedSolid* solid, G4double tolerance, G4Transform3D& placement)
+{
+    OMMesh mesh = OMMeshTools::getMesh(solid);
+    if (mesh.vertices.size() < 4) return nullptr;
+
+    const G4String name = solid->GetName();
+    const size_t   n    = mesh.vertices.size();
+
+    G4double                  best_residual = -1;
+    std::function<G4VSolid*()> best_create;
+
+    auto consider = [&](G4double residual, const G4Transform3D& frame, std::function<G4VSolid*()> create)
+    {
+        if (residual < 0 || (best_residual >= 0 && residual >= best_residual)) return;
+        best_residual = residual;
+        best_create   = create;
+        placement     = frame;
+    };
+
+    //-----------
+    // sphere: vertices on up to two concentric spheres, cut by cones around the axis towards the vertex centroid
+    //-----------
+
+    {
+        G4ThreeVector      centre = mesh.centroid;
+        std::vector<G4int> shell(n, 0);
+        G4int              nr_of_shells = 1;
+        G4bool             solved       = true;
+
+        for (G4int iteration = 0; iteration < 4; iteration++)
+        {
+            // |p|^2 = 2 c.p + k_shell is linear in the centre and one constant per shell (centred for conditioning)
+            const size_t size = 3 + nr_of_shells;
+            std::vector<std::vector<G4double>> a(size, std::vector<G4double>(size, 0));
+            std::vector<G4double>              b(size, 0);
+            for (size_t i = 0; i < n; i++)
+            {
+                G4ThreeVector         p = mesh.vertices[i] - mesh.centroid;
+                std::vector<G4double> row(size, 0);
+                for (G4int k = 0; k < 3; k++) row[k] = 2 * p[k];
+                row[3 + shell[i]] = 1;
+                for (size_t j = 0; j < size; j++)
+                {
+                    b[j] += row[j] * p.mag2();
+                    for (size_t k = 0; k < size; k++) a[j][k] += row[j] * row[k];
+                }
+            }
+            solved = solveLinear(a, b);
+            if (!solved || nr_of_shells > 8) break;
+            centre = mesh.centroid + G4ThreeVector(b[0], b[1], b[2]);
+
+            // vertices at the same radius form a shell
+            std::vector<G4int> order(n);
+            for (size_t i = 0; i < n; i++) order[i] = i;
+            std::sort(order.begin(), order.end(), [&](G4int i, G4int j){return (mesh.vertices[i] - centre).mag2() < (mesh.vertices[j] - centre).mag2();});
+
+            nr_of_shells = 1;
+            shell[order[0]] = 0;
+            for (size_t i = 1; i < n; i++)
+            {
+                if ((mesh.vertices[order[i]] - centre).mag() - (mesh.vertices[order[i - 1]] - centre).mag() > tolerance) nr_of_shells++;
+                shell[order[i]] = nr_of_shells - 1;
+            }
+        }
+
+        if (solved && nr_of_shells <= 2)
+        {
+            std::vector<G4double> radius(nr_of_shells, 0);
+            std::vector<G4int>    count(nr_of_shells, 0);
+            for (size_t i = 0; i < n; i++)
+            {
+                radius[shell[i]] += (mesh.vertices[i] - centre).mag();
+                count[shell[i]]++;
+            }
+            for (G4int k = 0; k < nr_of_shells; k++) radius[k] /= count[k];
+
+            const G4double rmin = nr_of_shells == 2 && radius[0] > tolerance ? radius[0] : 0.;
+            const G4double rmax = radius[nr_of_shells - 1];
+
+            // opening angles around the axis, closed to a full sphere if the gap is below the tolerance
+            G4ThreeVector axis      = mesh.centroid - centre;
+            G4double      theta_min = 0;
+            G4double      theta_max = pi;
+            if (axis.mag() > tolerance)
+            {
+                axis = axis.unit();
+                theta_min = pi;
+                theta_max = 0;
+                for (const G4ThreeVector& vertex : mesh.vertices)
+                {
+                    if ((vertex - centre).mag() < tolerance) continue;
+                    G4double theta = (vertex - centre).angle(axis);
+                    theta_min = std::min(theta_min, theta);
+                    theta_max = std::max(theta_max, theta);
+                }
+                if (rmax * theta_min        < tolerance) theta_min = 0;
+                if (rmax * (pi - theta_max) < tolerance) theta_max = pi;
+            }
+            else axis = G4ThreeVector(0, 0, 1);
+
+            auto distance = [=](const G4ThreeVector& p)
+            {
+                const G4double rho = p.perp(), z = p.z();
+                G4double d = arcDistance(rho, z, rmax, theta_min, theta_max);
+                if (rmin > 0)       d = std::min(d, arcDistance(rho, z, rmin, theta_min, theta_max));
+                if (theta_min > 0)  d = std::min(d, segmentDistance(rho, z, rmin * std::sin(theta_min), rmin * std::cos(theta_min), rmax * std::sin(theta_min), rmax * std::cos(theta_min)));
+                if (theta_max < pi) d = std::min(d, segmentDistance(rho, z, rmin * std::sin(theta_max), rmin * std::cos(theta_max), rmax * std::sin(theta_max), rmax * std::cos(theta_max)));
+                return d;
+            };
+            G4double      volume = twopi / 3 * (rmax * rmax * rmax - rmin * rmin * rmin) * (std::cos(theta_min) - std::cos(theta_max));
+            G4Transform3D frame  = frameAlong(axis, centre);
+
+            consider(OMMeshTools::fitResidual(mesh, frame, volume, tolerance, distance), frame, [=]() -> G4VSolid*
+            {
+                if (rmin == 0 && theta_min == 0 && theta_max == pi) return new G4Orb(name, rmax);
+                return new G4Sphere(name, rmin, rmax, 0, twopi, theta_min, theta_max - theta_min);
+            });
+        }
+    }
+
+    //-----------
+    // tube and cone: rims at both ends along one of the principal axes
+    //-----------
+
+    for (const G4ThreeVector& axis : mesh.axes)
+    {
+        G4double z_min = DBL_MAX, z_max = -DBL_MAX;
+        std::vector<G4double> rho(n), z(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            G4ThreeVector p = mesh.vertices[i] - mesh.centroid;
+            z[i]   = p.dot(axis);
+            rho[i] = (p - z[i] * axis).mag();
+            z_min  = std::min(z_min, z[i]);
+            z_max  = std::max(z_max, z[i]);
+        }
+        if (z_max - z_min < tolerance) continue;
+
+        // inner and outer radius at the lower (1) and upper (2) end
+        G4double rmin1 = DBL_MAX, rmax1 = 0, rmin2 = DBL_MAX, rmax2 = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (z[i] < z_min + tolerance) {rmin1 = std::min(rmin1, rho[i]); rmax1 = std::max(rmax1, rho[i]);}
+            if (z[i] > z_max - tolerance) {rmin2 = std::min(rmin2, rho[i]); rmax2 = std::max(rmax2, rho[i]);}
+        }
+        if (rmin1 < tolerance) rmin1 = 0;
+        if (rmin2 < tolerance) rmin2 = 0;
+
+        const G4bool tube = std::fabs(rmin1 - rmin2) <= tolerance && std::fabs(rmax1 - rmax2) <= tolerance;
+        if (tube)
+        {
+            rmin1 = rmin2 = (rmin1 + rmin2) / 2;
+            rmax1 = rmax2 = (rmax1 + rmax2) / 2;
+        }
+        const G4double dz = (z_max - z_min) / 2;
+
+        auto distance = [=](const G4ThreeVector& p)
+        {
+            const G4double rho = p.perp(), z = p.z();
+            G4double d = std::min({segmentDistance(rho, z, rmin1, -dz, rmax1, -dz),
+                                   segmentDistance(rho, z, rmax1, -dz, rmax2,  dz),
+                                   segmentDistance(rho, z, rmax2,  dz, rmin2,  dz)});
+            if (rmin1 > 0 || rmin2 > 0) d = std::min(d, segmentDistance(rho, z, rmin2, dz, rmin1, -dz));
+            return d;
+        };
+        G4double      volume = pi * 2 * dz / 3 * (rmax1 * rmax1 + rmax1 * rmax2 + rmax2 * rmax2 - rmin1 * rmin1 - rmin1 * rmin2 - rmin2 * rmin2);
+        G4Transform3D frame  = frameAlong(axis, mesh.centroid + (z_min + z_max) / 2 * axis);
+
+        consider(OMMeshTools::fitResidual(mesh, frame, volume, tolerance, distance), frame, [=]() -> G4VSolid*
+        {
+            if (tube) return new G4Tubs(name, rmin1, rmax1, dz, 0, twopi);
+            return new G4Cons(name, rmin1, rmax1, rmin2, rmax2, dz, 0, twopi);
+        });
+    }
+
+    //-----------
+    // ellipsoid: semi axes along the principal axes
+    //-----------
+
+    {
+        const G4ThreeVector axes[3] = {mesh.axes[0], mesh.axes[1], mesh.axes[0].cross(mesh.axes[1])};
+        G4double semi_axes[3] = {0, 0, 0};
+        for (const G4ThreeVector& vertex : mesh.vertices)
+        {
+            for (G4int k = 0; k < 3; k++) semi_axes[k] = std::max(semi_axes[k], std::fabs((vertex - mesh.centroid).dot(axes[k])));
+        }
+
+        if (semi_axes[2] > tolerance)
+        {
+            // distance along the ray from the centre, never smaller than the distance to the surface
+            auto distance = [=](const G4ThreeVector& p)
+            {
+                G4double f = std::sqrt(std::pow(p.x() / semi_axes[0], 2) + std::pow(p.y() / semi_axes[1], 2) + std::pow(p.z() / semi_axes[2], 2));
+                if (f == 0) return std::min({semi_axes[0], semi_axes[1], semi_axes[2]});
+                return p.mag() * std::fabs(1 - 1 / f);
+            };
+            G4double      volume = 4 * pi / 3 * semi_axes[0] * semi_axes[1] * semi_axes[2];
+            G4Transform3D frame(G4RotationMatrix(axes[0], axes[1], axes[2]), mesh.centroid);
+
+            consider(OMMeshTools::fitResidual(mesh, frame, volume, tolerance, distance), frame, [=]() -> G4VSolid*
+            {
+                return new G4Ellipsoid(name, semi_axes[0], semi_axes[1], semi_axes[2]);
+            });
+        }
+    }
+
+    return best_create ? best_create() : nullptr;
+}
+
+G4double OMMeshTools::fitSphere(const std::vector<G4ThreeVector>& points, G4ThreeVector& centre, G4double& radius)
+{
+    if (points.size() < 4) return -1;
+
+    G4ThreeVector mean;
+    for (const G4ThreeVector& point : points) mean += point;
+    mean /= points.size();
+
+    // |p|^2 = 2 c.p + k is linear in the centre and k (centred for conditioning)
+    std::vector<std::vector<G4double>> a(4, std::vector<G4double>(4, 0));
+    std::vector<G4double>              b(4, 0);
+    for (const G4ThreeVector& point : points)
+    {
+        G4ThreeVector p = point - mean;
+        G4double      row[4] = {2 * p.x(), 2 * p.y(), 2 * p.z(), 1};
+        for (G4int j = 0; j < 4; j++)
+        {
+            b[j] += row[j] * p.mag2();
+            for (G4int k = 0; k < 4; k++) a[j][k] += row[j] * row[k];
+        }
+    }
+    if (!solveLinear(a, b)) return -1;
+
+    G4ThreeVector offset(b[0], b[1], b[2]);
+    G4double      radius2 = b[3] + offset.mag2();
+    if (radius2 <= 0) return -1;
+
+    centre = mean + offset;
+    radius = std::sqrt(radius2);
+
+    G4double residual = 0;
+    for (const G4ThreeVector& point : points) residual = std::max(residual, std::fabs((point - centre).mag() - radius));
+    return residual;
+}
+
+G4TessellatedSolid* OMMeshTools::convexHull(const G4String& name, const std::vector<G4ThreeVector>& points)
+{
+    const size_t n = points.size();
+    if (n < 4) return nullptr;
+
+    G4ThreeVector lower = points[0], upper = points[0];
+    for (const G4ThreeVector& point : points)
+    {
+        for (G4int k = 0; k < 3; k++)
+        {
+            lower[k] = std::min(lower[k], point[k]);
+            upper[k] = std::max(upper[k], point[k]);
+        }
+    }
+    const G4double eps = 1e-10 * (upper - lower).mag();
+
+    //-----------
+    // faces and the directed edges referencing them
+    //-----------
+
+    struct Face
+    {
+        G4int              v[3];
+        G4ThreeVector      normal;
+        G4double           offset;
+        std::vector<G4int> outside;     // points above this face, not assigned to any other face
+        G4bool             alive;
+    };
+
+    std::vector<Face>                        faces;
+    std::unordered_map<std::uint64_t, G4int> edge_face;
+    auto key = [n](G4int a, G4int b){return (std::uint64_t) a * n + b;};
+
+    auto distance = [&](G4int f, G4int p){return faces[f].normal.dot(points[p]) - faces[f].offset;};
+
+    auto addFace = [&](G4int a, G4int b, G4int c)
+    {
+        Face face;
+        face.v[0]   = a;
+        face.v[1]   = b;
+        face.v[2]   = c;
+        face.normal = (points[b] - points[a]).cross(points[c] - points[a]).unit();
+        face.offset = face.normal.dot(points[a]);
+        face.alive  = true;
+        faces.push_back(face);
+
+        const G4int index = faces.size() - 1;
+        edge_face[key(a, b)] = index;
+        edge_face[key(b, c)] = index;
+        edge_face[key(c, a)] = index;
+        return index;
+    };
+
+    //-----------
+    // initial tetrahedron from extreme points
+    //-----------
+
+    G4int axis = 0;
+    for (G4int k = 1; k < 3; k++) if (upper[k] - lower[k] > upper[axis] - lower[axis]) axis = k;
+
+    G4int i0 = 0, i1 = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (points[i][axis] < points[i0][axis]) i0 = i;
+        if (points[i][axis] > points[i1][axis]) i1 = i;
+    }
+
+    G4int    i2 = -1;
+    G4double max_distance = eps;
+    const G4ThreeVector line = (points[i1] - points[i0]).unit();
+    for (size_t i = 0; i < n; i++)
+    {
+        G4double d = (points[i] - points[i0]).cross(line).mag();
+        if (d > max_distance) {max_distance = d; i2 = i;}
+    }
+    if (i2 < 0) return nullptr;
+
+    G4int    i3 = -1;
+    G4double max_height = eps;
+    const G4ThreeVector plane_normal = (points[i1] - points[i0]).cross(points[i2] - points[i0]).unit();
+    for (size_t i = 0; i < n; i++)
+    {
+        G4double d = std::fabs(plane_normal.dot(points[i] - points[i0]));
+        if (d > max_height) {max_height = d; i3 = i;}
+    }
+    if (i3 < 0) return nullptr;
+
+    // the fourth point has to be below the first face
+    if (plane_normal.dot(points[i3] - points[i0]) > 0) std::swap(i1, i2);
+
+    std::vector<G4int> pending = {addFace(i0, i1, i2), addFace(i0, i3, i1), addFace(i1, i3, i2), addFace(i2, i3, i0)};
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if ((G4int) i == i0 || (G4int) i == i1 || (G4int) i == i2 || (G4int) i == i3) continue;
+        for (G4int f = 0; f < 4; f++)
+        {
+            if (distance(f, i) > eps) {faces[f].outside.push_back(i); break;}
+        }
+    }
+
+    //-----------
+    // add the farthest outside point of a face, replacing all faces it sees
+    //-----------
+
+    std::vector<G4int> visit_stamp;
+    G4int              stamp = 0;
+
+    while (!pending.empty())
+    {
+        const G4int f = pending.back();
+        pending.pop_back();
+        if (!faces[f].alive || faces[f].outside.empty()) continue;
+
+        G4int apex = faces[f].outside.front();
+        for (G4int p : faces[f].outside) if (distance(f, p) > distance(f, apex)) apex = p;
+
+        // visible faces by flood fill, the horizon are the edges towards faces that are not visible
+        stamp++;
+        visit_stamp.resize(faces.size(), 0);
+        std::vector<G4int>                  visible = {f};
+        std::vector<std::pair<G4int, G4int>> horizon;
+        visit_stamp[f] = stamp;
+        for (size_t k = 0; k < visible.size(); k++)
+        {
+            const Face& face = faces[visible[k]];
+            for (G4int e = 0; e < 3; e++)
+            {
+                G4int a = face.v[e], b = face.v[(e + 1) % 3];
+                G4int neighbour = edge_face.at(key(b, a));
+                if (visit_stamp[neighbour] == stamp) continue;
+                if (distance(neighbour, apex) > eps)
+                {
+                    visit_stamp[neighbour] = stamp;
+                    visible.push_back(neighbour);
+                }
+                else horizon.push_back({a, b});
+            }
+        }
+
+        std::vector<G4int> orphans;
+        for (G4int v : visible)
+        {
+            faces[v].alive = false;
+            for (G4int p : faces[v].outside) if (p != apex) orphans.push_back(p);
+            faces[v].outside.clear();
+            for (G4int e = 0; e < 3; e++) edge_face.erase(key(faces[v].v[e], faces[v].v[(e + 1) % 3]));
+        }
+
+        std::vector<G4int> created;
+        for (const std::pair<G4int, G4int>& edge : horizon) created.push_back(addFace(edge.first, edge.second, apex));
+
+        for (G4int p : orphans)
+        {
+            for (G4int c : created)
+            {
+                if (distance(c, p) > eps) {faces[c].outside.push_back(p); break;}
+            }
+        }
+        pending.insert(pending.end(), created.begin(), created.end());
+    }
+
+    //-----------
+    // solid from the remaining faces
+    //-----------
+
+    G4TessellatedSolid* hull = new G4TessellatedSolid(name);
+    for (const Face& face : faces)
+    {
+        if (!face.alive) continue;
+        hull->AddFacet(new G4TriangularFacet(points[face.v[0]], points[face.v[1]], points[face.v[2]], ABSOLUTE));
+    }
+    hull->SetSolidClosed(true);
+
+    return hull;
+}
\ No newline at end of file
@@ -0,0 +1,258 @@
+// system includes
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+
+// G4 includes
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4Navigator.hh"
+#include "G4GeometryManager.hh"
+#include "G4Transform3D.hh"
+#include "G4Point3D.hh"
+#include "G4ios.hh"
+
+// project includes
+#include "OMNavigationTuner.hh"
+
+// besides the world and the envelope, mother volumes with at least this many daughters and the largest meshes are tuned
+static const G4int    min_nr_of_daughters = 8;
+static const size_t   nr_of_meshes        = 3;
+static const G4int    max_nr_of_steps     = 10000;   // per ray
+
+static const std::vector<G4double> smartless_candidates = {0.5, 1, 2, 4, 8, 16};     // G4 default: 2
+static const std::vector<G4double> voxel_candidates     = {1000, 4000, 16000, 64000};
+
+
+OMNavigationTuner::OMNavigationTuner(G4VPhysicalVolume* world, G4String filename)
+: _world(world),
+ _filename(filename),
+ _centre(0,0,0),
+ _radius(0)
+{
+    //-----------
+    // bounding sphere of all daughters of the world
+    //-----------
+
+    G4LogicalVolume* world_logical = world->GetLogicalVolume();
+    std::vector<G4ThreeVector> corners;
+    for (size_t i = 0; i < world_logical->GetNoDaughters(); i++)
+    {
+        G4VPhysicalVolume* daughter = world_logical->GetDaughter(i);
+        G4Transform3D      placement(daughter->GetObjectRotationValue(), daughter->GetObjectTranslation());
+
+        G4ThreeVector lower, upper;
+        daughter->GetLogicalVolume()->GetSolid()->BoundingLimits(lower, upper);
+        for (G4int corner = 0; corner < 8; corner++)
+        {
+            G4Point3D point(corner & 1 ? upper.x() : lower.x(), corner & 2 ? upper.y() : lower.y(), corner & 4 ? upper.z() : lower.z());
+            corners.push_back(point.transform(placement));
+        }
+    }
+    if (corners.empty()) return;
+
+    G4ThreeVector lower = corners.front(), upper = corners.front();
+    for (const G4ThreeVector& corner : corners)
+    {
+        for (G4int k = 0; k < 3; k++)
+        {
+            lower[k] = std::min(lower[k], corner[k]);
+            upper[k] = std::max(upper[k], corner[k]);
+        }
+    }
+    this->_centre = (lower + upper) / 2;
+    this->_radius = (upper - lower).mag() / 2;
+}
+
+OMNavigationTuner::~OMNavigationTuner()
+{
+}
+
+std::vector<OMNavigationTuner::Setting> OMNavigationTuner::getSettings()
+{
+    std::vector<Setting>             settings;
+    std::vector<G4TessellatedSolid*> meshes;
+
+    // the world and the mothers directly placed in it (envelope)
+    std::set<G4LogicalVolume*> top_mothers = {this->_world->GetLogicalVolume()};
+    for (size_t i = 0; i < this->_world->GetLogicalVolume()->GetNoDaughters(); i++)
+    {
+        G4LogicalVolume* daughter = this->_world->GetLogicalVolume()->GetDaughter(i)->GetLogicalVolume();
+        if (daughter->GetNoDaughters() > 0) top_mothers.insert(daughter);
+    }
+
+    for (G4LogicalVolume* logical : *G4LogicalVolumeStore::GetInstance())
+    {
+        if (top_mothers.count(logical) > 0 || logical->GetNoDaughters() >= size_t(min_nr_of_daughters))
+        {
+            settings.push_back({logical, nullptr, logical->GetSmartless()});
+        }
+
+        G4TessellatedSolid* tessellated = dynamic_cast<G4TessellatedSolid*>(logical->GetSolid());
+        if (tessellated != nullptr && std::find(meshes.begin(), meshes.end(), tessellated) == meshes.end()) meshes.push_back(tessellated);
+    }
+
+    std::sort(meshes.begin(), meshes.end(), [](G4TessellatedSolid* a, G4TessellatedSolid* b){return a->GetNumberOfFacets() > b->GetNumberOfFacets();});
+    if (meshes.size() > nr_of_meshes) meshes.resize(nr_of_meshes);
+
+    for (G4TessellatedSolid* tessellated : meshes)
+    {
+        G4ThreeVector reduction;
+        settings.push_back({nullptr, tessellated, G4double(tessellated->GetVoxels().GetMaxVoxels(reduction))});
+    }
+    return settings;
+}
+
+void OMNavigationTuner::setValue(Setting& setting, G4double value)
+{
+    setting.value = value;
+    if (setting.logical != nullptr)
+    {
+        setting.logical->SetSmartless(value);
+    }
+    else
+    {
+        // closing the solid again rebuilds its voxels
+        setting.tessellated->SetMaxVoxels(G4int(value));
+        setting.tessellated->SetSolidClosed(true);
+    }
+}
+
+G4double OMNavigationTuner::benchmark(G4int nr_of_rays)
+{
+    G4GeometryManager::GetInstance()->CloseGeometry(true, false);
+
+    G4Navigator navigator;
+    navigator.SetWorldVolume(this->_world);
+
+    // the same rays for every setting: from the bounding sphere towards a random point in its inner half
+    std::mt19937                     generator(1);
+    std::normal_distribution<double> normal;
+    auto randomDirection = [&](){return G4ThreeVector(normal(generator), normal(generator), normal(generator)).unit();};
+
+    G4double best = 0;
+    for (G4int repetition = 0; repetition < 2; repetition++)
+    {
+        generator.seed(1);
+        auto start = std::chrono::steady_clock::now();
+
+        for (G4int ray = 0; ray < nr_of_rays; ray++)
+        {
+            G4ThreeVector point     = this->_centre + this->_radius * randomDirection();
+            G4ThreeVector target    = this->_centre + this->_radius / 2 * randomDirection();
+            G4ThreeVector direction = (target - point).unit();
+
+            G4VPhysicalVolume* volume = navigator.LocateGlobalPointAndSetup(point, &direction, false, false);
+            for (G4int step = 0; step < max_nr_of_steps && volume != nullptr; step++)
+            {
+                G4double safety;
+                G4double length = navigator.ComputeStep(point, direction, kInfinity, safety);
+                if (length == kInfinity) break;
+
+                point += length * direction;
+                navigator.SetGeometricallyLimitedStep();
+                volume = navigator.LocateGlobalPointAndSetup(point, &direction, true);
+            }
+        }
+
+        G4double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = repetition == 0 ? elapsed : std::min(best, elapsed);
+    }
+
+    G4GeometryManager::GetInstance()->OpenGeometry();
+    return best;
+}
+
+void OMNavigationTuner::tune(G4int nr_of_rays)
+{
+    std::vector<Setting> settings = this->getSettings();
+
+    const G4double initial_time = this->benchmark(nr_of_rays);
+    G4double       best_time    = initial_time;
+
+    for (Setting& setting : settings)
+    {
+        const std::vector<G4double>& candidates = setting.logical != nullptr ? smartless_candidates : voxel_candidates;
+
+        G4double best_value = setting.value;
+        for (G4double candidate : candidates)
+        {
+            if (candidate == best_value) continue;
+
+            this->setValue(setting, candidate);
+            G4double time = this->benchmark(nr_of_rays);
+
+            // a new setting has to be clearly faster, the timings fluctuate by a few percent
+            if (time < 0.98 * best_time)
+            {
+                best_time  = time;
+                best_value = candidate;
+            }
+        }
+        this->setValue(setting, best_value);
+
+        G4cout << ">> navigation tuning: "
+               << (setting.logical != nullptr ? "smartless of " + setting.logical->GetName() : "voxel limit of " + setting.tessellated->GetName())
+               << " = " << best_value << G4endl;
+    }
+
+    G4cout << ">> navigation tuning: " << nr_of_rays << " rays in " << initial_time << " s with the default settings, "
+           << best_time << " s with the tuned settings" << G4endl;
+
+    if (this->_filename != "" && !this->write(settings))
+    {
+        G4Exception("OMNavigationTuner::tune()",
+                    "can not write navigation settings",
+                    JustWarning,
+                    ("The tuned navigation settings could not be written to " + this->_filename).c_str());
+    }
+}
+
+G4bool OMNavigationTuner::write(const std::vector<Setting>& settings)
+{
+    std::ofstream file(this->_filename);
+    if (!file.is_open()) return false;
+
+    file << "# navigation settings written by OMNavigationTuner, applied by volume (smartless) and solid (voxels) name" << std::endl;
+    for (const Setting& setting : settings)
+    {
+        if (setting.logical != nullptr) file << "smartless " << setting.logical->GetName()     << " " << setting.value << std::endl;
+        else                            file << "voxels "    << setting.tessellated->GetName() << " " << setting.value << std::endl;
+    }
+    return bool(file);
+}
+
+G4bool OMNavigationTuner::apply()
+{
+    std::ifstream file(this->_filename);
+    if (!file.is_open()) return false;
+
+    G4int       nr_applied = 0;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        std::string        type, name;
+        G4double           value;
+        if (!(stream >> type >> name >> value) || type[0] == '#') continue;
+
+        for (G4LogicalVolume* logical : *G4LogicalVolumeStore::GetInstance())
+        {
+            Setting setting = {nullptr, nullptr, 0};
+            if (type == "smartless" && logical->GetName() == name) setting.logical = logical;
+            if (type == "voxels" && logical->GetSolid()->GetName() == name) setting.tessellated = dynamic_cast<G4TessellatedSolid*>(logical->GetSolid());
+            if (setting.logical == nullptr && setting.tessellated == nullptr) continue;
+
+            this->setValue(setting, value);
+            nr_applied++;
+        }
+    }
+
+    G4cout << ">> navigation settings applied from " << this->_filename << " (" << nr_applied << " volumes)" << G4endl;
+    return true;
+}
\ No newline at end of file
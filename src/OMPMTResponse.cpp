@@ -0,0 +1,202 @@
+// system includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+// G4 includes
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+
+// project includes
+#include "OMPMTResponse.hh"
+
+static const char     pmt_response_magic[8] = "OMPMTR1";
+static const uint32_t default_nr_of_bins[3] = {24, 10, 12};     // entry position, incidence angle, energy
+static const uint32_t default_samples       = 64;
+static const double   default_energy_range[2] = {1.5, 4.5};     // eV
+
+
+OMPMTResponse* OMPMTResponse::_instance = nullptr;
+
+OMPMTResponse* OMPMTResponse::getInstance()
+{
+    if( _instance == nullptr )
+    {
+        _instance = new OMPMTResponse();
+    }
+    return _instance;
+}
+
+OMPMTResponse::OMPMTResponse()
+: _mode("off"),
+ _filename(""),
+ _pending_track_id(-1),
+ _pending_bin(-1),
+ _pending_time(0),
+ _nr_of_empty_lookups(0)
+{
+    std::memset(&this->_header, 0, sizeof(OMPMTResponseHeader));
+}
+
+OMPMTResponse::~OMPMTResponse()
+{
+}
+
+void OMPMTResponse::reset(const G4ThreeVector& centre, const G4ThreeVector& axis)
+{
+    std::memset(&this->_header, 0, sizeof(OMPMTResponseHeader));
+    std::memcpy(this->_header.magic, pmt_response_magic, sizeof(pmt_response_magic));
+    this->_header.sample_size     = sizeof(OMPMTResponseSample);
+    this->_header.samples_per_bin = default_samples;
+    for (G4int i = 0; i < 3; i++)
+    {
+        this->_header.nr_of_bins[i] = default_nr_of_bins[i];
+        this->_header.centre[i]     = centre[i] / mm;
+        this->_header.axis[i]       = axis.unit()[i];
+    }
+    this->_header.energy_range[0] = default_energy_range[0];
+    this->_header.energy_range[1] = default_energy_range[1];
+
+    this->_entries.assign(this->getNrOfBins(), 0);
+    this->_detections.assign(this->getNrOfBins(), 0);
+    this->_nr_of_samples.assign(this->getNrOfBins(), 0);
+    this->_samples.assign(this->getNrOfBins() * this->_header.samples_per_bin, OMPMTResponseSample());
+
+    this->_pending_bin         = -1;
+    this->_nr_of_empty_lookups = 0;
+}
+
+G4bool OMPMTResponse::read(const G4String& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    OMPMTResponseHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(OMPMTResponseHeader));
+    if (!file || std::memcmp(header.magic, pmt_response_magic, sizeof(pmt_response_magic)) != 0) return false;
+    if (header.sample_size != sizeof(OMPMTResponseSample)) return false;
+
+    this->_header = header;
+    const size_t nr_of_bins = this->getNrOfBins();
+    this->_entries.resize(nr_of_bins);
+    this->_detections.resize(nr_of_bins);
+    this->_nr_of_samples.resize(nr_of_bins);
+    this->_samples.resize(nr_of_bins * header.samples_per_bin);
+
+    file.read(reinterpret_cast<char*>(this->_entries.data()),       nr_of_bins * sizeof(uint64_t));
+    file.read(reinterpret_cast<char*>(this->_detections.data()),    nr_of_bins * sizeof(uint64_t));
+    file.read(reinterpret_cast<char*>(this->_nr_of_samples.data()), nr_of_bins * sizeof(uint32_t));
+    file.read(reinterpret_cast<char*>(this->_samples.data()),       this->_samples.size() * sizeof(OMPMTResponseSample));
+
+    this->_pending_bin         = -1;
+    this->_nr_of_empty_lookups = 0;
+    return bool(file);
+}
+
+G4bool OMPMTResponse::write(const G4String& filename)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    file.write(reinterpret_cast<const char*>(&this->_header),               sizeof(OMPMTResponseHeader));
+    file.write(reinterpret_cast<const char*>(this->_entries.data()),       this->_entries.size() * sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(this->_detections.data()),    this->_detections.size() * sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(this->_nr_of_samples.data()), this->_nr_of_samples.size() * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(this->_samples.data()),       this->_samples.size() * sizeof(OMPMTResponseSample));
+    return bool(file);
+}
+
+G4int OMPMTResponse::getBin(const G4ThreeVector& position, const G4ThreeVector& direction, const G4ThreeVector& normal, G4double energy)
+{
+    G4ThreeVector centre(this->_header.centre[0] * mm, this->_header.centre[1] * mm, this->_header.centre[2] * mm);
+    G4ThreeVector axis(this->_header.axis[0], this->_header.axis[1], this->_header.axis[2]);
+
+    // all three variables are mapped to [0, 1)
+    G4double variables[3];
+    variables[0] = ((position - centre).unit().dot(axis) + 1) / 2;
+    variables[1] = - direction.dot(normal);
+    variables[2] = (energy / eV - this->_header.energy_range[0]) / (this->_header.energy_range[1] - this->_header.energy_range[0]);
+
+    G4int bin = 0;
+    for (G4int i = 0; i < 3; i++)
+    {
+        G4int nr_of_bins = this->_header.nr_of_bins[i];
+        G4int index      = std::min(nr_of_bins - 1, std::max(0, G4int(variables[i] * nr_of_bins)));
+        bin = bin * nr_of_bins + index;
+    }
+    return bin;
+}
+
+void OMPMTResponse::recordEntry(G4int track_id, G4int bin, G4double time, const G4AffineTransform& global_to_local)
+{
+    this->_entries[bin]++;
+
+    this->_pending_track_id        = track_id;
+    this->_pending_bin             = bin;
+    this->_pending_time            = time;
+    this->_pending_global_to_local = global_to_local;
+}
+
+void OMPMTResponse::recordDetection(G4int track_id, G4double time, const G4ThreeVector& position, G4double angle, G4double weight)
+{
+    if (this->_pending_bin < 0 || track_id != this->_pending_track_id) return;
+
+    const G4int bin = this->_pending_bin;
+    this->_pending_bin = -1;
+    this->_detections[bin]++;
+
+    G4ThreeVector       local = this->_pending_global_to_local.TransformPoint(position);
+    OMPMTResponseSample sample;
+    sample.delay  = (time - this->_pending_time) / ns;
+    for (G4int i = 0; i < 3; i++) sample.position[i] = local[i] / mm;
+    sample.angle  = angle;
+    sample.weight = weight;
+
+    // reservoir sampling keeps a uniform subset of all detections in the bin
+    const uint32_t samples_per_bin = this->_header.samples_per_bin;
+    if (this->_nr_of_samples[bin] < samples_per_bin)
+    {
+        this->_samples[bin * samples_per_bin + this->_nr_of_samples[bin]++] = sample;
+        return;
+    }
+
+    uint64_t slot = G4RandFlat::shootInt((long) this->_detections[bin]);
+    if (slot < samples_per_bin) this->_samples[bin * samples_per_bin + slot] = sample;
+}
+
+const OMPMTResponseSample* OMPMTResponse::sample(G4int bin)
+{
+    if (this->_entries[bin] == 0)
+    {
+        this->_nr_of_empty_lookups++;
+        return nullptr;
+    }
+
+    if (G4UniformRand() * this->_entries[bin] >= this->_detections[bin] || this->_nr_of_samples[bin] == 0) return nullptr;
+
+    uint32_t slot = G4RandFlat::shootInt((long) this->_nr_of_samples[bin]);
+    return &this->_samples[bin * this->_header.samples_per_bin + slot];
+}
+
+void OMPMTResponse::printSummary()
+{
+    if (this->_mode == "off") return;
+
+    uint64_t entries = 0, detections = 0;
+    G4int    filled  = 0;
+    for (G4int bin = 0; bin < this->getNrOfBins(); bin++)
+    {
+        entries    += this->_entries[bin];
+        detections += this->_detections[bin];
+        if (this->_entries[bin] > 0) filled++;
+    }
+
+    G4cout << ">> PMT response table: " << entries << " entries, " << detections << " detections, "
+           << filled << " of " << this->getNrOfBins() << " bins filled" << G4endl;
+    if (this->_nr_of_empty_lookups > 0)
+    {
+        G4cout << ">> fast PMT model: " << this->_nr_of_empty_lookups << " photons entered in bins without entries and were not detected" << G4endl;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+// system includes
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// G4 includes
+
+// project includes
+#include "OMPhaseSpace.hh"
+
+static const char   phase_space_magic[8] = "OMPHSP1";
+static const size_t writer_buffer_size   = 1 << 16;   // records
+
+
+OMPhaseSpaceWriter::OMPhaseSpaceWriter()
+{
+    std::memset(&this->_header, 0, sizeof(OMPhaseSpaceHeader));
+}
+
+OMPhaseSpaceWriter::~OMPhaseSpaceWriter()
+{
+    this->close();
+}
+
+bool OMPhaseSpaceWriter::open(const std::string& filename, double radius, const double centre[3])
+{
+    this->close();
+
+    std::memset(&this->_header, 0, sizeof(OMPhaseSpaceHeader));
+    std::memcpy(this->_header.magic, phase_space_magic, sizeof(phase_space_magic));
+    this->_header.record_size = sizeof(OMPhaseSpaceRecord);
+    this->_header.radius      = radius;
+    for (int i = 0; i < 3; i++) this->_header.centre[i] = centre[i];
+
+    this->_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!this->_file.is_open()) return false;
+
+    // header is written again with the final record count on close
+    this->_file.write(reinterpret_cast<const char*>(&this->_header), sizeof(OMPhaseSpaceHeader));
+    this->_buffer.reserve(writer_buffer_size);
+    return true;
+}
+
+void OMPhaseSpaceWriter::write(const OMPhaseSpaceRecord& record)
+{
+    this->_buffer.push_back(record);
+    this->_header.nr_of_records++;
+    if (this->_buffer.size() >= writer_buffer_size) this->flush();
+}
+
+void OMPhaseSpaceWriter::flush()
+{
+    if (this->_buffer.empty()) return;
+    this->_file.write(reinterpret_cast<const char*>(this->_buffer.data()), this->_buffer.size() * sizeof(OMPhaseSpaceRecord));
+    this->_buffer.clear();
+}
+
+void OMPhaseSpaceWriter::close()
+{
+    if (!this->_file.is_open()) return;
+
+    this->flush();
+    this->_file.seekp(0);
+    this->_file.write(reinterpret_cast<const char*>(&this->_header), sizeof(OMPhaseSpaceHeader));
+    this->_file.close();
+}
+
+///-----------------------------------------------------------------------
+
+OMPhaseSpaceReader::OMPhaseSpaceReader()
+: _map(nullptr),
+ _map_size(0),
+ _records(nullptr),
+ _block_size(1 << 16),
+ _current_block(0)
+{
+    std::memset(&this->_header, 0, sizeof(OMPhaseSpaceHeader));
+}
+
+OMPhaseSpaceReader::~OMPhaseSpaceReader()
+{
+    this->close();
+}
+
+bool OMPhaseSpaceReader::open(const std::string& filename)
+{
+    this->close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || (size_t) file_stat.st_size < sizeof(OMPhaseSpaceHeader))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    this->_map_size = file_stat.st_size;
+    this->_map      = mmap(nullptr, this->_map_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);    // the mapping stays valid
+
+    if (this->_map == MAP_FAILED)
+    {
+        this->_map = nullptr;
+        return false;
+    }
+
+    std::memcpy(&this->_header, this->_map, sizeof(OMPhaseSpaceHeader));
+
+    // sanity checks on header and file size
+    uint64_t expected_size = sizeof(OMPhaseSpaceHeader) + this->_header.nr_of_records * sizeof(OMPhaseSpaceRecord);
+    if (std::memcmp(this->_header.magic, phase_space_magic, sizeof(phase_space_magic)) != 0 ||
+        this->_header.record_size != sizeof(OMPhaseSpaceRecord) ||
+        expected_size > this->_map_size)
+    {
+        this->close();
+        return false;
+    }
+
+    this->_records = reinterpret_cast<const OMPhaseSpaceRecord*>(static_cast<const char*>(this->_map) + sizeof(OMPhaseSpaceHeader));
+
+    // records are consumed front to back
+    madvise(this->_map, this->_map_size, MADV_SEQUENTIAL);
+    this->_current_block = 0;
+    this->adviseBlock(0, MADV_WILLNEED);
+    return true;
+}
+
+void OMPhaseSpaceReader::close()
+{
+    if (this->_map != nullptr) munmap(this->_map, this->_map_size);
+    this->_map      = nullptr;
+    this->_map_size = 0;
+    this->_records  = nullptr;
+    std::memset(&this->_header, 0, sizeof(OMPhaseSpaceHeader));
+}
+
+const OMPhaseSpaceRecord& OMPhaseSpaceReader::getRecord(uint64_t index)
+{
+    uint64_t block = index / this->_block_size;
+    if (block != this->_current_block)
+    {
+        // release what is behind, prefetch what is ahead
+        if (block > this->_current_block) this->adviseBlock(this->_current_block, MADV_DONTNEED);
+        this->adviseBlock(block + 1, MADV_WILLNEED);
+        this->_current_block = block;
+    }
+    return this->_records[index];
+}
+
+void OMPhaseSpaceReader::adviseBlock(uint64_t block, int advice)
+{
+    if (block * this->_block_size >= this->_header.nr_of_records) return;
+
+    // madvise needs page aligned addresses
+    static const uint64_t page_size = sysconf(_SC_PAGESIZE);
+
+    uint64_t begin = sizeof(OMPhaseSpaceHeader) + block * this->_block_size * sizeof(OMPhaseSpaceRecord);
+    uint64_t end   = std::min<uint64_t>(begin + this->_block_size * sizeof(OMPhaseSpaceRecord), this->_map_size);
+    begin -= begin % page_size;
+
+    madvise(static_cast<char*>(this->_map) + begin, end - begin, advice);
+}
@@ -0,0 +1,25 @@
+// system includes
+
+// G4 includes
+
+// project includes
+#include "OMPhotocathodeHit.hh"
+
+G4ThreadLocal G4Allocator<OMPhotocathodeHit>* OMPhotocathodeHitAllocator = nullptr;
+
+OMPhotocathodeHit::OMPhotocathodeHit()
+: G4VHit(),
+ _channel(0),
+ _time(0),
+ _position(0),
+ _direction(0),
+ _wavelength(0),
+ _incidence_angle(0),
+ _weight(1)
+{
+    for (G4int i = 0; i < nr_of_path_materials; i++) this->_path_lengths[i] = 0;
+}
+
+OMPhotocathodeHit::~OMPhotocathodeHit()
+{
+}
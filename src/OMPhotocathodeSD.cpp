@@ -0,0 +1,109 @@
+// system includes
+#include <algorithm>
+#include <cmath>
+
+// G4 includes
+#include "G4SDManager.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4VProcess.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4AffineTransform.hh"
+#include "G4VSolid.hh"
+
+// project includes
+#include "OMPhotocathodeSD.hh"
+#include "OMMaterialManager.hh"
+#include "OMDataManager.hh"
+#include "OMPMTResponse.hh"
+
+
+OMPhotocathodeSD::OMPhotocathodeSD(G4String name, G4String hits_collection_name, G4bool qe_weighting, G4int channel_depth)
+: G4VSensitiveDetector(name),
+ _qe_weighting(qe_weighting),
+ _channel_depth(channel_depth),
+ _hits_collection(nullptr),
+ _hits_collection_id(-1),
+ _hits_reserve(64)
+{
+    this->collectionName.insert(hits_collection_name);
+}
+
+OMPhotocathodeSD::~OMPhotocathodeSD()
+{
+}
+
+void OMPhotocathodeSD::Initialize(G4HCofThisEvent* HCE)
+{
+    this->_hits_collection = new OMPhotocathodeHitsCollection(this->SensitiveDetectorName, this->collectionName[0]);
+    this->_hits_collection->GetVector()->reserve(this->_hits_reserve);
+
+    if (this->_hits_collection_id < 0) this->_hits_collection_id = G4SDManager::GetSDMpointer()->GetCollectionID(this->_hits_collection);
+    HCE->AddHitsCollection(this->_hits_collection_id, this->_hits_collection);
+}
+
+G4bool OMPhotocathodeSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{
+    G4Track* track = step->GetTrack();
+    if (track->GetDefinition() != G4OpticalPhoton::Definition()) return false;
+
+    G4StepPoint* pre_step  = step->GetPreStepPoint();
+    G4StepPoint* post_step = step->GetPostStepPoint();
+
+    G4double weight = track->GetWeight();
+
+    if (this->_qe_weighting)
+    {
+        // every photon entering the photocathode is detected with weight = QE, nothing is left to chance
+        if (pre_step->GetStepStatus() != fGeomBoundary) return false;
+        weight *= OMMaterialManager::getInstance()->GetQuantumEfficiency(pre_step->GetTotalEnergy());
+        track->SetTrackStatus(fStopAndKill);
+    }
+    else
+    {
+        // a photon counts as detected if it is absorbed inside the photocathode
+        const G4VProcess* process = post_step->GetProcessDefinedStep();
+        if (process == nullptr || process->GetProcessName() != "OpAbsorption") return false;
+    }
+
+    OMPhotocathodeHit* hit = new OMPhotocathodeHit();
+    hit->setChannel(pre_step->GetTouchableHandle()->GetCopyNumber(this->_channel_depth));
+    hit->setTime(post_step->GetGlobalTime());
+    hit->setPosition(post_step->GetPosition() / mm);
+    hit->setDirection(pre_step->GetMomentumDirection());
+    hit->setWavelength(h_Planck * c_light / pre_step->GetTotalEnergy() / nm);
+    hit->setIncidenceAngle(this->getIncidenceAngle(pre_step));
+    hit->setWeight(weight);
+    hit->setPathLengths(OMDataManager::getInstance()->getPathLengths());
+    this->addHit(hit);
+
+    // the detailed PMT model fills the response table of the fast model
+    OMPMTResponse* response = OMPMTResponse::getInstance();
+    if (response->getGenerate())
+    {
+        response->recordDetection(track->GetTrackID(), hit->getTime(), post_step->GetPosition(), hit->getIncidenceAngle(), weight / track->GetWeight());
+    }
+
+    return true;
+}
+
+void OMPhotocathodeSD::addHit(OMPhotocathodeHit* hit)
+{
+    this->_hits_collection->insert(hit);
+
+    // keep the preallocated capacity in line with the busiest event seen so far
+    this->_hits_reserve = std::max(this->_hits_reserve, this->_hits_collection->GetSize());
+}
+
+
+G4double OMPhotocathodeSD::getIncidenceAngle(G4StepPoint* step_point)
+{
+    // surface normal of the photocathode at the (local) position of the photon
+    const G4AffineTransform& global2local = step_point->GetTouchableHandle()->GetHistory()->GetTopTransform();
+    G4VSolid* solid = step_point->GetTouchableHandle()->GetSolid();
+
+    G4ThreeVector local_normal  = solid->SurfaceNormal(global2local.TransformPoint(step_point->GetPosition()));
+    G4ThreeVector global_normal = global2local.Inverse().TransformAxis(local_normal);
+
+    return std::acos(std::min(1., std::abs(global_normal.dot(step_point->GetMomentumDirection()))));
+}
\ No newline at end of file
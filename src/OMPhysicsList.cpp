@@ -0,0 +1,180 @@
+// system includes
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+// G4 includes
+#include "G4SystemOfUnits.hh"
+#include "G4OpticalPhysics.hh"
+#include "G4FastSimulationPhysics.hh"
+#include "G4EmStandardPhysics.hh"
+#include "G4EmExtraPhysics.hh"
+#include "G4DecayPhysics.hh"
+#include "G4HadronElasticPhysics.hh"
+#include "G4HadronPhysicsFTFP_BERT.hh"
+#include "G4StoppingPhysics.hh"
+#include "G4IonPhysics.hh"
+#include "G4NeutronTrackingCut.hh"
+#include "G4Geantino.hh"
+#include "G4ChargedGeantino.hh"
+#include "G4Material.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Version.hh"
+
+// project includes
+#include "OMPhysicsList.hh"
+
+// read by OMMaterialManager, part of the physics table key
+static const char optical_properties_file[] = "macros/optical_properties.cfg";
+
+
+OMPhysicsList::OMPhysicsList(G4String variant)
+: G4VModularPhysicsList(),
+ _variant(variant),
+ _table_cache(""),
+ _table_directory(""),
+ _store_tables(false)
+{
+    this->_PhysicsListMessenger = new OMPhysicsListMessenger(this);
+
+    if (!isVariant(variant))
+    {
+        G4Exception("OMPhysicsList::OMPhysicsList()",
+                    "unknown physics list",
+                    FatalErrorInArgument,
+                    ("Unknown physics list " + variant + ", use optical, em or full").c_str());
+    }
+
+    this->SetDefaultCutValue(0.7*mm);
+
+    //------------
+    // charged particles (Cherenkov light of muons and their secondaries)
+    //------------
+
+    if (variant == "em" || variant == "full")
+    {
+        this->RegisterPhysics(new G4EmStandardPhysics());
+        this->RegisterPhysics(new G4DecayPhysics());
+    }
+
+    // same constructors as FTFP_BERT
+    if (variant == "full")
+    {
+        this->RegisterPhysics(new G4EmExtraPhysics());
+        this->RegisterPhysics(new G4HadronElasticPhysics());
+        this->RegisterPhysics(new G4HadronPhysicsFTFP_BERT());
+        this->RegisterPhysics(new G4StoppingPhysics());
+        this->RegisterPhysics(new G4IonPhysics());
+        this->RegisterPhysics(new G4NeutronTrackingCut());
+    }
+
+    //------------
+    // optical photons
+    //------------
+
+    this->RegisterPhysics(new G4OpticalPhysics());
+
+    // fast simulation of photons in the PMTs (only active with /geometry/PMT/fastModel)
+    G4FastSimulationPhysics* fast_simulation = new G4FastSimulationPhysics();
+    fast_simulation->ActivateFastSimulation("opticalphoton");
+    this->RegisterPhysics(fast_simulation);
+}
+
+OMPhysicsList::~OMPhysicsList()
+{
+    delete this->_PhysicsListMessenger;
+}
+
+void OMPhysicsList::ConstructParticle()
+{
+    G4VModularPhysicsList::ConstructParticle();
+
+    // the general particle source starts with a geantino before /gps/particle is set
+    G4Geantino::GeantinoDefinition();
+    G4ChargedGeantino::ChargedGeantinoDefinition();
+}
+
+//-----------
+// physics table cache
+//-----------
+
+std::uint64_t OMPhysicsList::getTableKey()
+{
+    // FNV-1a over everything the tables depend on
+    std::stringstream settings;
+    settings << G4Version << " " << this->_variant << " " << this->GetDefaultCutValue() << "\n";
+
+    for (G4Region* region : *G4RegionStore::GetInstance())
+    {
+        settings << region->GetName();
+        G4ProductionCuts* cuts = region->GetProductionCuts();
+        if (cuts != nullptr) for (G4int i = 0; i < NumberOfG4CutIndex; i++) settings << " " << cuts->GetProductionCut(i);
+        settings << "\n";
+    }
+
+    for (G4Material* material : *G4Material::GetMaterialTable())
+    {
+        settings << material->GetName() << " " << material->GetDensity() << " " << material->GetNumberOfElements() << "\n";
+    }
+
+    std::ifstream optical_properties(optical_properties_file, std::ios::binary);
+    settings << optical_properties.rdbuf();
+
+    std::uint64_t key = 14695981039346656037ULL;
+    for (char c : settings.str()) key = (key ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    return key;
+}
+
+void OMPhysicsList::SetCuts()
+{
+    G4VModularPhysicsList::SetCuts();
+
+    this->_store_tables = false;
+    if (this->_table_cache == "") return;
+
+    std::stringstream directory;
+    directory << this->_table_cache << "/physics_" << std::hex << std::setw(16) << std::setfill('0') << this->getTableKey();
+    this->_table_directory = directory.str();
+
+    // the keyed directory only appears once all tables are stored
+    if (std::filesystem::is_directory(std::string(this->_table_directory)))
+    {
+        this->SetPhysicsTableRetrieved(this->_table_directory);
+        G4cout << ">> physics tables are retrieved from " << this->_table_directory << G4endl;
+    }
+    else
+    {
+        this->ResetPhysicsTableRetrieved();
+        this->_store_tables = true;
+    }
+}
+
+void OMPhysicsList::storeTables()
+{
+    if (!this->_store_tables) return;
+    this->_store_tables = false;
+
+    // store to a temporary directory first, so concurrent jobs never retrieve incomplete tables
+    const std::string tmp_directory = this->_table_directory + ".tmp" + std::to_string(getpid());
+    std::error_code   error;
+    std::filesystem::create_directories(tmp_directory, error);
+
+    if (!error && this->StorePhysicsTable(tmp_directory))
+    {
+        std::filesystem::rename(tmp_directory, std::string(this->_table_directory), error);
+        if (!error) G4cout << ">> physics tables stored in " << this->_table_directory << G4endl;
+    }
+    else
+    {
+        G4Exception("OMPhysicsList::storeTables()",
+                    "can not store physics tables",
+                    JustWarning,
+                    ("The physics tables could not be stored in " + this->_table_directory).c_str());
+    }
+
+    // another job stored the same tables in the meantime, or storing failed
+    std::filesystem::remove_all(tmp_directory, error);
+}
\ No newline at end of file
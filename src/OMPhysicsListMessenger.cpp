@@ -0,0 +1,38 @@
+// system includes
+
+// G4 includes
+
+// project includes
+#include "OMPhysicsListMessenger.hh"
+
+
+OMPhysicsListMessenger::OMPhysicsListMessenger(OMPhysicsList* physics_list)
+: G4UImessenger(),
+ _PhysicsList(physics_list)
+{
+    this->_physicsDir = new G4UIdirectory("/physics/");
+    this->_physicsDir->SetGuidance("options of the physics list");
+
+    this->_tableCacheCmd = new G4UIcmdWithAString("/physics/tableCache",this);
+    this->_tableCacheCmd->SetGuidance("directory in which the physics tables are stored after the first run and retrieved from in later jobs.");
+    this->_tableCacheCmd->SetGuidance("The tables are keyed by a hash of the physics list, the production cuts, the materials and optical_properties.cfg. Empty to disable.");
+    this->_tableCacheCmd->SetParameterName("directory",true);
+    this->_tableCacheCmd->SetDefaultValue("");
+    this->_tableCacheCmd->AvailableForStates(G4State_PreInit);
+    this->_tableCacheCmd->SetToBeBroadcasted(false);
+}
+
+OMPhysicsListMessenger::~OMPhysicsListMessenger()
+{
+    delete this->_physicsDir;
+    delete this->_tableCacheCmd;
+}
+
+void OMPhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    // set physics table cache
+    if ( command == this->_tableCacheCmd )
+    {
+        this->_PhysicsList->setTableCache(newValue);
+    }
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 // system includes
+#include <algorithm>
 
 // G4 includes
 #include "G4Event.hh"
@@ -7,14 +8,25 @@
 #include "G4SystemOfUnits.hh"
 #include "G4OpticalPhoton.hh"
 #include "G4RandomDirection.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4RunManager.hh"
 
 // project includes
 #include "OMPrimaryGenerator.hh"
+#include "OMPrimaryGeneratorMessenger.hh"
 
 
 OMPrimaryGenerator::OMPrimaryGenerator()
 : G4VUserPrimaryGeneratorAction(),
- _generalParticleSource(nullptr)
+ _generalParticleSource(nullptr),
+ _mode("gps"),
+ _phasespace_filename(""),
+ _phasespace_index(0),
+ _photons_per_event(1),
+ _list_filename(""),
+ _list_photons_per_event(1),
+ _list_event_offset(0)
 {
     /*
         NOTE:
@@ -49,15 +61,121 @@ OMPrimaryGenerator::OMPrimaryGenerator()
     currentSource->GetEneDist()->SetEnergyDisType("Mono");
     currentSource->GetEneDist()->SetMonoEnergy(3.0 *eV);
 
+    this->_PrimaryGeneratorMessenger = new OMPrimaryGeneratorMessenger(this);
+
 }
 
 OMPrimaryGenerator::~OMPrimaryGenerator()
 {
     delete this->_generalParticleSource;
+    delete this->_PrimaryGeneratorMessenger;
+}
+
+void OMPrimaryGenerator::setPhaseSpaceFilename(G4String filename)
+{
+    this->_phasespace_reader.close();
+    this->_phasespace_filename = filename;
+    this->_phasespace_index    = 0;
+}
+
+void OMPrimaryGenerator::setListFilename(G4String filename)
+{
+    this->_list_reader.close();
+    this->_list_filename = filename;
 }
 
 void OMPrimaryGenerator::GeneratePrimaries(G4Event* event)
 {
+    if (this->_mode == "phasespace")
+    {
+        this->generatePhaseSpacePrimaries(event);
+        return;
+    }
+
+    if (this->_mode == "list")
+    {
+        this->generateListPrimaries(event);
+        return;
+    }
+
     this->_generalParticleSource->SetParticlePolarization(G4RandomDirection());
     this->_generalParticleSource->GeneratePrimaryVertex(event);
+}
+
+void OMPrimaryGenerator::generatePhaseSpacePrimaries(G4Event* event)
+{
+    if (!this->_phasespace_reader.isOpen() && !this->_phasespace_reader.open(this->_phasespace_filename))
+    {
+        G4Exception("OMPrimaryGenerator::generatePhaseSpacePrimaries()",
+                    "can not open phase space file",
+                    RunMustBeAborted,
+                    ("the phase space file " + this->_phasespace_filename + " could not be read!").c_str());
+        G4RunManager::GetRunManager()->AbortRun();
+        return;
+    }
+
+    for (G4int i = 0; i < this->_photons_per_event; i++)
+    {
+        if (this->_phasespace_index >= this->_phasespace_reader.getNrOfRecords())
+        {
+            G4Exception("OMPrimaryGenerator::generatePhaseSpacePrimaries()",
+                        "end of phase space file",
+                        JustWarning,
+                        "all photons of the phase space file have been replayed, the run is aborted!");
+            G4RunManager::GetRunManager()->AbortRun(true);
+            return;
+        }
+
+        this->addPhoton(event, this->_phasespace_reader.getRecord(this->_phasespace_index++));
+    }
+}
+
+void OMPrimaryGenerator::generateListPrimaries(G4Event* event)
+{
+    if (!this->_list_reader.isOpen() && !this->_list_reader.open(this->_list_filename))
+    {
+        G4Exception("OMPrimaryGenerator::generateListPrimaries()",
+                    "can not open primary list",
+                    RunMustBeAborted,
+                    ("the primary list " + this->_list_filename + " could not be read!").c_str());
+        G4RunManager::GetRunManager()->AbortRun();
+        return;
+    }
+
+    // the record range only depends on the event id, so processes with different
+    // event offsets (or threads with different event ids) read disjoint ranges
+    std::uint64_t event_nr = static_cast<std::uint64_t>(event->GetEventID()) + this->_list_event_offset;
+    std::uint64_t first    = event_nr * this->_list_photons_per_event;
+    std::uint64_t last     = std::min(first + this->_list_photons_per_event, this->_list_reader.getNrOfRecords());
+
+    if (first >= this->_list_reader.getNrOfRecords())
+    {
+        G4Exception("OMPrimaryGenerator::generateListPrimaries()",
+                    "end of primary list",
+                    JustWarning,
+                    "the primary list holds no records for this event, the run is aborted!");
+        G4RunManager::GetRunManager()->AbortRun(true);
+        return;
+    }
+
+    for (std::uint64_t index = first; index < last; index++)
+    {
+        this->addPhoton(event, this->_list_reader.getRecord(index));
+    }
+}
+
+void OMPrimaryGenerator::addPhoton(G4Event* event, const OMPhaseSpaceRecord& record)
+{
+    // records are stored in mm, ns and eV
+    G4PrimaryVertex* vertex = new G4PrimaryVertex(G4ThreeVector(record.position[0], record.position[1], record.position[2]) * mm,
+                                                  record.time * ns);
+
+    G4PrimaryParticle* photon = new G4PrimaryParticle(G4OpticalPhoton::Definition());
+    photon->SetMomentumDirection(G4ThreeVector(record.direction[0], record.direction[1], record.direction[2]));
+    photon->SetPolarization(G4ThreeVector(record.polarisation[0], record.polarisation[1], record.polarisation[2]));
+    photon->SetKineticEnergy(record.energy * eV);
+    photon->SetWeight(record.weight);
+
+    vertex->SetPrimary(photon);
+    event->AddPrimaryVertex(vertex);
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+// system includes
+
+// G4 includes
+
+// project includes
+#include "OMPrimaryGeneratorMessenger.hh"
+
+
+OMPrimaryGeneratorMessenger::OMPrimaryGeneratorMessenger(OMPrimaryGenerator* Generator)
+: G4UImessenger(),
+ _PrimaryGenerator(Generator)
+{
+    this->_primaryDir = new G4UIdirectory("/primary/");
+    this->_primaryDir->SetGuidance("options for the primary generator");
+
+    this->_modeCmd = new G4UIcmdWithAString("/primary/mode",this);
+    this->_modeCmd->SetGuidance("Generate primaries with the general particle source (gps), replay a recorded phase space (phasespace) or read an external primary list (list).");
+    this->_modeCmd->SetParameterName("mode",false);
+    this->_modeCmd->SetCandidates("gps phasespace list");
+    this->_modeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_modeCmd->SetToBeBroadcasted(false);
+
+    this->_phaseSpaceDir = new G4UIdirectory("/primary/phasespace/");
+    this->_phaseSpaceDir->SetGuidance("replay of a phase space recorded with /daq/phasespace/");
+
+    this->_phaseSpaceFileCmd = new G4UIcmdWithAString("/primary/phasespace/file",this);
+    this->_phaseSpaceFileCmd->SetGuidance("Set the phase space file to replay. The file is replayed from its first record.");
+    this->_phaseSpaceFileCmd->SetParameterName("filename",false);
+    this->_phaseSpaceFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_phaseSpaceFileCmd->SetToBeBroadcasted(false);
+
+    this->_phaseSpacePerEventCmd = new G4UIcmdWithAnInteger("/primary/phasespace/photonsPerEvent",this);
+    this->_phaseSpacePerEventCmd->SetGuidance("Number of recorded photons generated per event.");
+    this->_phaseSpacePerEventCmd->SetParameterName("photons",false);
+    this->_phaseSpacePerEventCmd->SetRange("photons >= 1");
+    this->_phaseSpacePerEventCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_phaseSpacePerEventCmd->SetToBeBroadcasted(false);
+
+    this->_listDir = new G4UIdirectory("/primary/list/");
+    this->_listDir->SetGuidance("externally generated photons in the phase space file format");
+
+    this->_listFileCmd = new G4UIcmdWithAString("/primary/list/file",this);
+    this->_listFileCmd->SetGuidance("Set the primary list to read the photons from.");
+    this->_listFileCmd->SetParameterName("filename",false);
+    this->_listFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_listFileCmd->SetToBeBroadcasted(false);
+
+    this->_listPerEventCmd = new G4UIcmdWithAnInteger("/primary/list/photonsPerEvent",this);
+    this->_listPerEventCmd->SetGuidance("Number of records per event, event N reads the records [N * photons, (N + 1) * photons).");
+    this->_listPerEventCmd->SetParameterName("photons",false);
+    this->_listPerEventCmd->SetRange("photons >= 1");
+    this->_listPerEventCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_listPerEventCmd->SetToBeBroadcasted(false);
+
+    this->_listEventOffsetCmd = new G4UIcmdWithAnInteger("/primary/list/eventOffset",this);
+    this->_listEventOffsetCmd->SetGuidance("Offset added to the event id, lets several jobs process disjoint parts of one list.");
+    this->_listEventOffsetCmd->SetParameterName("offset",false);
+    this->_listEventOffsetCmd->SetRange("offset >= 0");
+    this->_listEventOffsetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_listEventOffsetCmd->SetToBeBroadcasted(false);
+}
+
+OMPrimaryGeneratorMessenger::~OMPrimaryGeneratorMessenger()
+{
+    delete this->_modeCmd;
+    delete this->_phaseSpaceFileCmd;
+    delete this->_phaseSpacePerEventCmd;
+    delete this->_phaseSpaceDir;
+    delete this->_listFileCmd;
+    delete this->_listPerEventCmd;
+    delete this->_listEventOffsetCmd;
+    delete this->_listDir;
+    delete this->_primaryDir;
+}
+
+void OMPrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    // Set generator mode
+    if ( command == this->_modeCmd )
+    {
+        this->_PrimaryGenerator->setMode(newValue);
+    }
+
+    // Set phase space file
+    if ( command == this->_phaseSpaceFileCmd )
+    {
+        this->_PrimaryGenerator->setPhaseSpaceFilename(newValue);
+    }
+
+    // Set photons per event
+    if ( command == this->_phaseSpacePerEventCmd )
+    {
+        this->_PrimaryGenerator->setPhotonsPerEvent(this->_phaseSpacePerEventCmd->GetNewIntValue(newValue));
+    }
+
+    // Set primary list
+    if ( command == this->_listFileCmd )
+    {
+        this->_PrimaryGenerator->setListFilename(newValue);
+    }
+
+    // Set primary list records per event
+    if ( command == this->_listPerEventCmd )
+    {
+        this->_PrimaryGenerator->setListPhotonsPerEvent(this->_listPerEventCmd->GetNewIntValue(newValue));
+    }
+
+    // Set primary list event offset
+    if ( command == this->_listEventOffsetCmd )
+    {
+        this->_PrimaryGenerator->setListEventOffset(this->_listEventOffsetCmd->GetNewIntValue(newValue));
+    }
+}
\ No newline at end of file
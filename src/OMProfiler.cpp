@@ -0,0 +1,277 @@
+// system includes
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// G4 includes
+#include "G4ios.hh"
+#include "G4Run.hh"
+#include "G4SystemOfUnits.hh"
+
+// project includes
+#include "OMProfiler.hh"
+#include "OMDataManager.hh"
+
+
+OMProfiler* OMProfiler::_instance = nullptr;
+
+OMProfiler* OMProfiler::getInstance()
+{
+    if( _instance == nullptr )
+    {
+        _instance = new OMProfiler();
+    }
+    return _instance;
+}
+
+OMProfiler::OMProfiler()
+: _creation(std::chrono::steady_clock::now()),
+ _startup_finished(false),
+ _startup_file(""),
+ _progress_interval(10 * s),
+ _run_summary_file(""),
+ _events_to_process(0),
+ _events_done(0),
+ _run_start(0),
+ _run_cpu_start(0),
+ _last_report(0),
+ _step_profiling(false),
+ _top_volumes(20)
+{
+    this->_ProfilerMessenger = new OMProfilerMessenger(this);
+}
+
+OMProfiler::~OMProfiler()
+{
+    delete this->_ProfilerMessenger;
+}
+
+G4double OMProfiler::getWallTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - this->_creation).count();
+}
+
+G4double OMProfiler::getRSS()
+{
+    // second field of statm: resident pages
+    long pages = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    if (!(statm >> pages >> resident)) return 0;
+    return resident * double(sysconf(_SC_PAGESIZE)) / (1024. * 1024.);
+}
+
+G4double OMProfiler::getCPUTime()
+{
+    // user and system time of all threads, unlike clock() not wrapping around
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+}
+
+G4double OMProfiler::getPeakRSS()
+{
+    // ru_maxrss is given in kB on Linux
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss / 1024.;
+}
+
+//-----------
+// phases
+//-----------
+
+void OMProfiler::startPhase(const G4String& name)
+{
+    Phase phase;
+    phase.name       = name;
+    phase.depth      = this->_open_phases.size();
+    phase.start      = this->getWallTime();
+    phase.wall       = 0;
+    phase.rss_start  = getRSS();
+    phase.rss_growth = 0;
+    phase.peak_rss   = 0;
+
+    this->_open_phases.push_back(this->_phases.size());
+    this->_phases.push_back(phase);
+}
+
+void OMProfiler::endPhase()
+{
+    if (this->_open_phases.empty()) return;
+
+    Phase& phase = this->_phases[this->_open_phases.back()];
+    this->_open_phases.pop_back();
+
+    phase.wall       = this->getWallTime() - phase.start;
+    phase.rss_growth = getRSS() - phase.rss_start;
+    phase.peak_rss   = getPeakRSS();
+}
+
+void OMProfiler::finishStartup()
+{
+    if (this->_startup_finished) return;
+    this->_startup_finished = true;
+
+    this->printStartup();
+
+    if (this->_startup_file == "") return;
+    if (this->writeStartup(this->_startup_file))
+    {
+        G4cout << ">> startup profile written to " << this->_startup_file << G4endl;
+    }
+    else
+    {
+        G4Exception("OMProfiler::finishStartup()",
+                    "can not write startup profile",
+                    JustWarning,
+                    ("The startup profile could not be written to " + this->_startup_file).c_str());
+    }
+}
+
+void OMProfiler::printStartup()
+{
+    G4cout << "==========================" << G4endl;
+    G4cout << ">> startup profile" << G4endl;
+    G4cout << std::left << std::setw(44) << ">> phase" << std::right
+           << std::setw(10) << "wall [s]" << std::setw(14) << "RSS +[MB]" << std::setw(14) << "peak RSS [MB]" << G4endl;
+
+    for (const Phase& phase : this->_phases)
+    {
+        G4String name = ">> " + G4String(2 * phase.depth, ' ') + phase.name;
+        G4cout << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(3)
+               << std::setw(10) << phase.wall
+               << std::setprecision(1) << std::setw(14) << phase.rss_growth << std::setw(14) << phase.peak_rss << G4endl;
+    }
+    G4cout << std::defaultfloat << std::setprecision(6);
+
+    G4cout << ">> startup finished after " << this->getWallTime() << " s, peak RSS " << getPeakRSS() << " MB" << G4endl;
+    G4cout << "==========================" << G4endl;
+}
+
+G4bool OMProfiler::writeStartup(const G4String& filename)
+{
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    file << "{" << std::endl;
+    file << "  \"wall_s\": " << this->getWallTime() << "," << std::endl;
+    file << "  \"peak_rss_mb\": " << getPeakRSS() << "," << std::endl;
+    file << "  \"phases\": [" << std::endl;
+    for (size_t i = 0; i < this->_phases.size(); i++)
+    {
+        const Phase& phase = this->_phases[i];
+        file << "    {\"name\": \"" << phase.name << "\", \"depth\": " << phase.depth
+             << ", \"start_s\": " << phase.start << ", \"wall_s\": " << phase.wall
+             << ", \"rss_growth_mb\": " << phase.rss_growth << ", \"peak_rss_mb\": " << phase.peak_rss << "}"
+             << (i + 1 < this->_phases.size() ? "," : "") << std::endl;
+    }
+    file << "  ]" << std::endl;
+    file << "}" << std::endl;
+    return bool(file);
+}
+
+//-----------
+// run progress
+//-----------
+
+void OMProfiler::beginRun(const G4Run* run)
+{
+    this->_events_to_process = run->GetNumberOfEventToBeProcessed();
+    this->_events_done       = 0;
+    this->_run_start         = this->getWallTime();
+    this->_run_cpu_start     = getCPUTime();
+    this->_last_report       = this->_run_start;
+}
+
+void OMProfiler::endEvent()
+{
+    this->_events_done++;
+    if (this->_progress_interval <= 0) return;
+
+    // the wall time is read once per event, which is negligible against the tracking of an event
+    G4double now = this->getWallTime();
+    if (now - this->_last_report < this->_progress_interval / s) return;
+
+    this->_last_report = now;
+    this->printProgress();
+}
+
+OMProfiler::RunMetrics OMProfiler::getRunMetrics()
+{
+    RunMetrics metrics;
+    metrics.events   = this->_events_done;
+    metrics.tracks   = OMDataManager::getInstance()->getNrOfTracks();
+    metrics.steps    = OMDataManager::getInstance()->getNrOfSteps();
+    metrics.wall     = this->getWallTime() - this->_run_start;
+    metrics.cpu      = getCPUTime() - this->_run_cpu_start;
+    metrics.rss      = getRSS();
+    metrics.peak_rss = getPeakRSS();
+    return metrics;
+}
+
+void OMProfiler::printProgress()
+{
+    RunMetrics metrics = this->getRunMetrics();
+    if (metrics.wall <= 0) return;
+
+    const G4double event_rate = metrics.events / metrics.wall;
+    const G4int    remaining  = this->_events_to_process - metrics.events;
+
+    G4cout << ">> progress: " << metrics.events << " / " << this->_events_to_process << " events ("
+           << std::fixed << std::setprecision(1) << 100. * metrics.events / std::max(1, this->_events_to_process) << " %), "
+           << event_rate << " events/s, " << metrics.tracks / metrics.wall << " tracks/s, " << metrics.steps / metrics.wall << " steps/s, "
+           << "ETA " << (event_rate > 0 ? remaining / event_rate : 0) << " s, wall " << metrics.wall << " s, CPU " << metrics.cpu << " s, "
+           << "RSS " << metrics.rss << " MB" << std::defaultfloat << std::setprecision(6) << G4endl;
+}
+
+void OMProfiler::endRun(const G4Run* run)
+{
+    RunMetrics metrics = this->getRunMetrics();
+
+    G4cout << ">> run " << run->GetRunID() << " finished in " << metrics.wall << " seconds (CPU " << metrics.cpu << " seconds)." << G4endl;
+    if (metrics.wall > 0)
+    {
+        G4cout << ">> " << metrics.events << " events, " << metrics.events / metrics.wall << " events per second" << G4endl;
+        G4cout << ">> " << metrics.tracks << " tracks, " << metrics.tracks / metrics.wall << " tracks per second" << G4endl;
+        G4cout << ">> " << metrics.steps  << " steps, "  << metrics.steps  / metrics.wall << " steps per second" << G4endl;
+    }
+    G4cout << ">> RSS " << metrics.rss << " MB, peak RSS " << metrics.peak_rss << " MB" << G4endl;
+
+    if (this->_run_summary_file == "") return;
+    if (this->writeRunSummary(this->_run_summary_file, run->GetRunID(), metrics))
+    {
+        G4cout << ">> run summary written to " << this->_run_summary_file << G4endl;
+    }
+    else
+    {
+        G4Exception("OMProfiler::endRun()",
+                    "can not write run summary",
+                    JustWarning,
+                    ("The run summary could not be written to " + this->_run_summary_file).c_str());
+    }
+}
+
+G4bool OMProfiler::writeRunSummary(const G4String& filename, G4int run_id, const RunMetrics& metrics)
+{
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    const G4double wall = std::max(metrics.wall, 1e-9);
+    file << "{" << std::endl;
+    file << "  \"run\": " << run_id << "," << std::endl;
+    file << "  \"events\": " << metrics.events << "," << std::endl;
+    file << "  \"tracks\": " << metrics.tracks << "," << std::endl;
+    file << "  \"steps\": " << metrics.steps << "," << std::endl;
+    file << "  \"wall_s\": " << metrics.wall << "," << std::endl;
+    file << "  \"cpu_s\": " << metrics.cpu << "," << std::endl;
+    file << "  \"events_per_s\": " << metrics.events / wall << "," << std::endl;
+    file << "  \"tracks_per_s\": " << metrics.tracks / wall << "," << std::endl;
+    file << "  \"steps_per_s\": " << metrics.steps / wall << "," << std::endl;
+    file << "  \"rss_mb\": " << metrics.rss << "," << std::endl;
+    file << "  \"peak_rss_mb\": " << metrics.peak_rss << "," << std::endl;
+    file << "  \"run_start_s\": " << this->_run_start << std::endl;   // since the start of the job
+    file << "}" << std::endl;
+    return bool(file);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+// system includes
+
+// G4 includes
+
+// project includes
+#include "OMProfilerMessenger.hh"
+
+
+OMProfilerMessenger::OMProfilerMessenger(OMProfiler* profiler)
+: G4UImessenger(),
+ _Profiler(profiler)
+{
+    this->_profileDir = new G4UIdirectory("/profile/");
+    this->_profileDir->SetGuidance("timing and memory profiles of the simulation");
+
+    this->_startupFileCmd = new G4UIcmdWithAString("/profile/startup_file",this);
+    this->_startupFileCmd->SetGuidance("JSON file for the wall time and memory of the startup phases, written after the first run initialisation. Empty to only print them.");
+    this->_startupFileCmd->SetParameterName("filename",true);
+    this->_startupFileCmd->SetDefaultValue("");
+    this->_startupFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_startupFileCmd->SetToBeBroadcasted(false);
+
+    this->_progressIntervalCmd = new G4UIcmdWithADoubleAndUnit("/profile/progress_interval",this);
+    this->_progressIntervalCmd->SetGuidance("wall time between two progress reports during a run (events, rates, ETA, wall/CPU time, memory). 0 disables the reports.");
+    this->_progressIntervalCmd->SetParameterName("interval",false);
+    this->_progressIntervalCmd->SetRange("interval >= 0");
+    this->_progressIntervalCmd->SetDefaultUnit("s");
+    this->_progressIntervalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_progressIntervalCmd->SetToBeBroadcasted(false);
+
+    this->_runSummaryFileCmd = new G4UIcmdWithAString("/profile/run_summary_file",this);
+    this->_runSummaryFileCmd->SetGuidance("JSON file for the event, track and step counts, rates, times and memory of the last run. Empty to only print them.");
+    this->_runSummaryFileCmd->SetParameterName("filename",true);
+    this->_runSummaryFileCmd->SetDefaultValue("");
+    this->_runSummaryFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_runSummaryFileCmd->SetToBeBroadcasted(false);
+
+    this->_stepProfilingCmd = new G4UIcmdWithABool("/profile/steps",this);
+    this->_stepProfilingCmd->SetGuidance("count steps, boundary crossings and wall time per physical volume and process, the hottest volumes are printed at the end of each run.");
+    this->_stepProfilingCmd->SetParameterName("yes/no",false);
+    this->_stepProfilingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_stepProfilingCmd->SetToBeBroadcasted(false);
+
+    this->_topVolumesCmd = new G4UIcmdWithAnInteger("/profile/top_volumes",this);
+    this->_topVolumesCmd->SetGuidance("number of volumes in the step profile, ordered by time. 0 prints all.");
+    this->_topVolumesCmd->SetParameterName("N",false);
+    this->_topVolumesCmd->SetRange("N >= 0");
+    this->_topVolumesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    this->_topVolumesCmd->SetToBeBroadcasted(false);
+}
+
+OMProfilerMessenger::~OMProfilerMessenger()
+{
+    delete this->_profileDir;
+    delete this->_startupFileCmd;
+    delete this->_progressIntervalCmd;
+    delete this->_runSummaryFileCmd;
+    delete this->_stepProfilingCmd;
+    delete this->_topVolumesCmd;
+}
+
+void OMProfilerMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    // set startup profile file
+    if ( command == this->_startupFileCmd )
+    {
+        this->_Profiler->setStartupFile(newValue);
+    }
+
+    // set progress report interval
+    if ( command == this->_progressIntervalCmd )
+    {
+        this->_Profiler->setProgressInterval(this->_progressIntervalCmd->GetNewDoubleValue(newValue));
+    }
+
+    // set run summary file
+    if ( command == this->_runSummaryFileCmd )
+    {
+        this->_Profiler->setRunSummaryFile(newValue);
+    }
+
+    // set step profiling
+    if ( command == this->_stepProfilingCmd )
+    {
+        this->_Profiler->setStepProfiling(this->_stepProfilingCmd->GetNewBoolValue(newValue));
+    }
+
+    if ( command == this->_topVolumesCmd )
+    {
+        this->_Profiler->setTopVolumes(this->_topVolumesCmd->GetNewIntValue(newValue));
+    }
+}
\ No newline at end of file
@@ -1,12 +1,16 @@
 // system includes
-#include <time.h>
 
 // G4 includes
 #include "G4ios.hh"
+#include "G4RunManager.hh"
 
 // project includes
 #include "OMRunAction.hh"
 #include "OMDataManager.hh"
+#include "OMPMTResponse.hh"
+#include "OMPhysicsList.hh"
+#include "OMProfiler.hh"
+#include "OMStepProfiler.hh"
 
 OMRunAction::OMRunAction()
 {
@@ -24,15 +28,38 @@ void OMRunAction::BeginOfRunAction(const G4Run* run)
     G4cout << ">> starting run " << run->GetRunID() << G4endl;
     OMDataManager::getInstance()->open();
 
-    this->startClock = clock();
+    // the physics tables are built by now, keep them for the next jobs
+    const G4VUserPhysicsList* physics_list = G4RunManager::GetRunManager()->GetUserPhysicsList();
+    OMPhysicsList* om_physics_list = dynamic_cast<OMPhysicsList*>(const_cast<G4VUserPhysicsList*>(physics_list));
+    if (om_physics_list != nullptr) om_physics_list->storeTables();
+
+    OMProfiler::getInstance()->beginRun(run);
+    if (OMProfiler::getInstance()->getStepProfiling()) OMStepProfiler::getInstance()->beginRun();
 }
 
 void OMRunAction::EndOfRunAction(const G4Run* run)
 {
-    this->endClock = clock();
-    double elapsed = double(endClock - startClock)/ (double) CLOCKS_PER_SEC;
-
+    OMDataManager::getInstance()->printTriggerSummary();
     OMDataManager::getInstance()->close();
-    G4cout << ">> run " << run->GetRunID() << " finished in " << elapsed << " seconds." << G4endl;
+
+    // the response table accumulates over all runs, it is rewritten after each one
+    OMPMTResponse::getInstance()->printSummary();
+    if (OMPMTResponse::getInstance()->getGenerate())
+    {
+        G4String filename = OMPMTResponse::getInstance()->getFilename();
+        if (OMPMTResponse::getInstance()->write(filename))
+        {
+            G4cout << ">> PMT response table written to " << filename << G4endl;
+        }
+        else
+        {
+            G4Exception("OMRunAction::EndOfRunAction()",
+                        "can not write PMT response table",
+                        JustWarning,
+                        ("The PMT response table could not be written to " + filename).c_str());
+        }
+    }
+    OMProfiler::getInstance()->endRun(run);
+    if (OMProfiler::getInstance()->getStepProfiling()) OMStepProfiler::getInstance()->report(OMProfiler::getInstance()->getTopVolumes());
     G4cout << "==========================" << G4endl;
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+// system includes
+
+// G4 includes
+
+// project includes
+#include "OMRunManager.hh"
+#include "OMProfiler.hh"
+
+
+OMRunManager::OMRunManager()
+: G4RunManager()
+{
+}
+
+OMRunManager::~OMRunManager()
+{
+}
+
+void OMRunManager::InitializeGeometry()
+{
+    OMProfiler::getInstance()->startPhase("detector construction");
+    G4RunManager::InitializeGeometry();
+    OMProfiler::getInstance()->endPhase();
+}
+
+void OMRunManager::InitializePhysics()
+{
+    OMProfiler::getInstance()->startPhase("physics list");
+    G4RunManager::InitializePhysics();
+    OMProfiler::getInstance()->endPhase();
+}
+
+void OMRunManager::RunInitialization()
+{
+    // the first run initialisation builds the physics tables and closes the geometry (voxelisation), both in one
+    // call of the kernel
+    OMProfiler* profiler = OMProfiler::getInstance();
+    if (profiler->getStartupFinished())
+    {
+        G4RunManager::RunInitialization();
+        return;
+    }
+
+    profiler->startPhase("physics tables and voxelisation");
+    G4RunManager::RunInitialization();
+    profiler->endPhase();
+
+    profiler->finishStartup();
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+// system includes
+#include <algorithm>
+#include <iomanip>
+#include <vector>
+
+// G4 includes
+#include "G4Step.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+#include "G4ios.hh"
+
+// project includes
+#include "OMStepProfiler.hh"
+
+
+G4ThreadLocal OMStepProfiler* OMStepProfiler::_instance = nullptr;
+
+OMStepProfiler* OMStepProfiler::getInstance()
+{
+    if( _instance == nullptr )
+    {
+        _instance = new OMStepProfiler();
+    }
+    return _instance;
+}
+
+OMStepProfiler::OMStepProfiler()
+: _last_volume(nullptr),
+ _last_volume_counters(nullptr),
+ _last_step(std::chrono::steady_clock::now())
+{
+}
+
+OMStepProfiler::~OMStepProfiler()
+{
+}
+
+void OMStepProfiler::beginRun()
+{
+    this->_volumes.clear();
+    this->_processes.clear();
+    this->_last_volume          = nullptr;
+    this->_last_volume_counters = nullptr;
+}
+
+void OMStepProfiler::step(const G4Step* step)
+{
+    const auto   now  = std::chrono::steady_clock::now();
+    const double time = std::chrono::duration<double>(now - this->_last_step).count();
+    this->_last_step  = now;
+
+    const G4bool boundary = step->GetPostStepPoint()->GetStepStatus() == fGeomBoundary;
+
+    const G4VPhysicalVolume* volume = step->GetPreStepPoint()->GetPhysicalVolume();
+    if (volume != this->_last_volume)
+    {
+        this->_last_volume          = volume;
+        this->_last_volume_counters = &this->_volumes[volume];
+    }
+    Counters& volume_counters = *this->_last_volume_counters;
+    volume_counters.steps++;
+    volume_counters.boundaries += boundary;
+    volume_counters.time       += time;
+
+    Counters& process_counters = this->_processes[step->GetPostStepPoint()->GetProcessDefinedStep()];
+    process_counters.steps++;
+    process_counters.boundaries += boundary;
+    process_counters.time       += time;
+}
+
+void OMStepProfiler::report(G4int top_n)
+{
+    G4long   total_steps = 0;
+    G4double total_time  = 0;
+    for (const auto& entry : this->_volumes)
+    {
+        total_steps += entry.second.steps;
+        total_time  += entry.second.time;
+    }
+    if (total_steps == 0) return;
+
+    auto printRow = [&](const G4String& name, const Counters& counters)
+    {
+        G4cout << ">>   " << std::left << std::setw(40) << name << std::right << std::fixed
+               << std::setw(12) << counters.steps << std::setw(12) << counters.boundaries
+               << std::setprecision(3) << std::setw(12) << counters.time
+               << std::setprecision(1) << std::setw(9) << 100. * counters.time / std::max(total_time, 1e-12) << " %"
+               << std::setprecision(0) << std::setw(12) << counters.time / counters.steps * 1e9 << G4endl;
+    };
+    auto printHeader = [](const G4String& title)
+    {
+        G4cout << ">> " << std::left << std::setw(42) << title << std::right << std::setw(12) << "steps" << std::setw(12) << "boundaries"
+               << std::setw(12) << "time [s]" << std::setw(11) << "share" << std::setw(12) << "ns/step" << G4endl;
+    };
+
+    //-----------
+    // hottest volumes
+    //-----------
+
+    std::vector<std::pair<const G4VPhysicalVolume*, Counters>> volumes(this->_volumes.begin(), this->_volumes.end());
+    std::sort(volumes.begin(), volumes.end(), [](const auto& a, const auto& b){return a.second.time > b.second.time;});
+    if (top_n > 0 && volumes.size() > size_t(top_n)) volumes.resize(top_n);
+
+    G4cout << "==========================" << G4endl;
+    printHeader("step profile: volume (copy nr)");
+    for (const auto& entry : volumes)
+    {
+        G4String name = entry.first != nullptr ? entry.first->GetName() + " (" + std::to_string(entry.first->GetCopyNo()) + ")" : "outside";
+        printRow(name, entry.second);
+    }
+
+    //-----------
+    // processes limiting the steps
+    //-----------
+
+    std::vector<std::pair<const G4VProcess*, Counters>> processes(this->_processes.begin(), this->_processes.end());
+    std::sort(processes.begin(), processes.end(), [](const auto& a, const auto& b){return a.second.time > b.second.time;});
+
+    printHeader("step profile: process");
+    for (const auto& entry : processes)
+    {
+        printRow(entry.first != nullptr ? entry.first->GetProcessName() : G4String("none"), entry.second);
+    }
+    G4cout << std::defaultfloat << std::setprecision(6);
+    G4cout << ">> " << total_steps << " steps in " << total_time << " s of tracking" << G4endl;
+    G4cout << "==========================" << G4endl;
+}
\ No newline at end of file
@@ -1,10 +1,15 @@
 // system includes
+#include <algorithm>
+#include <cmath>
 
 // G4 includes
 #include "G4SystemOfUnits.hh"
+#include "G4OpticalPhoton.hh"
 // project includes
 #include "OMSteppingAction.hh"
 #include "OMDataManager.hh"
+#include "OMProfiler.hh"
+#include "OMStepProfiler.hh"
 #include "G4VProcess.hh"
 
 OMSteppingAction::OMSteppingAction()
@@ -19,9 +24,28 @@ OMSteppingAction::~OMSteppingAction()
 
 void OMSteppingAction::UserSteppingAction(const G4Step* step)
 {
+    OMDataManager::getInstance()->countStep();
+
+    if (OMProfiler::getInstance()->getStepProfiling()) OMStepProfiler::getInstance()->step(step);
+
+    // geometric path length per material, for reweighting to different absorption lengths
+    if (OMDataManager::getInstance()->getRecordPathLengths())
+    {
+        OMDataManager::getInstance()->addPathLength(step->GetPreStepPoint()->GetMaterial(), step->GetStepLength() / mm);
+    }
+
     // sanity check to avoid segmentation error
     if (step->GetPostStepPoint()->GetPhysicalVolume() == nullptr) return;
 
+    // record photons crossing the phase space sphere inwards
+    if (OMDataManager::getInstance()->getRecordPhaseSpace() && step->GetTrack()->GetDefinition() == G4OpticalPhoton::Definition())
+    {
+        this->recordPhaseSpace(step);
+    }
+
+    // glass contact is only part of the track records
+    if (OMDataManager::getInstance()->getHitsOutput()) return;
+
     // if post step point is glass, hand over position and momentum to datamanager
     // post step point - position on glass
     // pre  step point - momentum direction before refraction
@@ -32,3 +56,37 @@ void OMSteppingAction::UserSteppingAction(const G4Step* step)
     }
 }
 
+
+
+void OMSteppingAction::recordPhaseSpace(const G4Step* step)
+{
+    OMDataManager* data_manager = OMDataManager::getInstance();
+
+    G4ThreeVector centre = data_manager->getPhaseSpaceCentre();
+    G4double      radius = data_manager->getPhaseSpaceRadius();
+
+    G4ThreeVector pre  = step->GetPreStepPoint()->GetPosition()  - centre;
+    G4ThreeVector post = step->GetPostStepPoint()->GetPosition() - centre;
+
+    if (pre.mag2() <= radius * radius || post.mag2() > radius * radius) return;
+
+    // photon steps are straight, solve |pre + f * (post - pre)| = radius for the crossing point
+    G4ThreeVector delta = post - pre;
+    G4double a = delta.mag2();
+    G4double b = 2 * pre.dot(delta);
+    G4double c = pre.mag2() - radius * radius;
+    G4double f = (- b - std::sqrt(std::max(0., b * b - 4 * a * c))) / (2 * a);
+
+    G4double pre_time  = step->GetPreStepPoint()->GetGlobalTime();
+    G4double post_time = step->GetPostStepPoint()->GetGlobalTime();
+
+    data_manager->phaseSpaceHandover((centre + pre + f * delta) / mm,
+                                     step->GetPreStepPoint()->GetMomentumDirection(),
+                                     step->GetPreStepPoint()->GetPolarization(),
+                                     step->GetPreStepPoint()->GetKineticEnergy() / eV,
+                                     (pre_time + f * (post_time - pre_time)) / ns,
+                                     step->GetTrack()->GetWeight());
+
+    // the module internals are simulated when the phase space is replayed
+    if (data_manager->getPhaseSpaceKill()) step->GetTrack()->SetTrackStatus(fStopAndKill);
+}
\ No newline at end of file
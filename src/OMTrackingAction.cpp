@@ -5,6 +5,9 @@
 // project includes
 #include "OMTrackingAction.hh"
 #include "OMDataManager.hh"
+#include "OMPMTResponse.hh"
+#include "OMProfiler.hh"
+#include "OMStepProfiler.hh"
 #include "G4VProcess.hh"
 
 OMTrackingAction::OMTrackingAction()
@@ -19,6 +22,13 @@ OMTrackingAction::~OMTrackingAction()
 
 void OMTrackingAction::PreUserTrackingAction(const G4Track* track)
 {
+    OMDataManager::getInstance()->beginTrack();
+
+    if (OMProfiler::getInstance()->getStepProfiling()) OMStepProfiler::getInstance()->beginTrack();
+
+    // hits are read from the photocathode sensitive detector, tracks are not recorded
+    if (OMDataManager::getInstance()->getHitsOutput()) return;
+
     OMDataManager::getInstance()->preTrackHandover(track->GetParticleDefinition()->GetPDGEncoding(),
                                                    track->GetGlobalTime(),
                                                    track->GetPosition() / mm,
@@ -28,25 +38,40 @@ void OMTrackingAction::PreUserTrackingAction(const G4Track* track)
 
 void OMTrackingAction::PostUserTrackingAction(const G4Track* track)
 {
+    // a pending PMT entry of this photon was not detected
+    if (OMPMTResponse::getInstance()->getGenerate()) OMPMTResponse::getInstance()->endTrack();
+
+    if (OMDataManager::getInstance()->getHitsOutput()) return;
 
     G4int copy_nr_depth = 0;
     G4String volume_name = track->GetTouchableHandle()->GetVolume()->GetName();
 
     // handle copy nr in PMT correctly -> will always get copy nr of pmt, not of parts inside
-    if (volume_name.find("photocathode") != std::string::npos) copy_nr_depth = 2;
+    if (volume_name.find("photocathode") != std::string::npos) copy_nr_depth = track->GetTouchableHandle()->GetVolume(1)->GetName() == "PMT" ? 1 : 2;
     else if (volume_name.find("Absorber") != std::string::npos) copy_nr_depth = 1;
     else if (volume_name.find("VacZylinder") != std::string::npos) copy_nr_depth = 1;
     else if (volume_name.find("upperVacSphere") != std::string::npos) copy_nr_depth = 1;
     else if (volume_name.find("lowerVacSphere") != std::string::npos) copy_nr_depth = 1;
 
-    
+
+    G4int    volume_copyno = track->GetTouchableHandle()->GetCopyNumber(copy_nr_depth);
+    G4String process_name  = track->GetStep()->GetPostStepPoint()->GetProcessDefinedStep()->GetProcessName();
+
+    // detected by the fast PMT model, the track ends on the PMT envelope
+    if (OMDataManager::getInstance()->getFastPMTChannel() >= 0)
+    {
+        volume_name   = "photocathode";
+        volume_copyno = OMDataManager::getInstance()->getFastPMTChannel();
+        process_name  = "FastPMT";
+    }
+
     OMDataManager::getInstance()->postTrackHandover(track->GetGlobalTime(),
                                                     track->GetPosition() / mm,
                                                     track->GetTotalEnergy() / eV,
                                                     track->GetMomentumDirection(),
                                                     volume_name,
-                                                    track->GetTouchableHandle()->GetCopyNumber(copy_nr_depth),
-                                                    track->GetStep()->GetPostStepPoint()->GetProcessDefinedStep()->GetProcessName());
+                                                    volume_copyno,
+                                                    process_name);
     OMDataManager::getInstance()->write();
     OMDataManager::getInstance()->reset();
 }